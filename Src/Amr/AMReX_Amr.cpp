@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstdio>
 #include <list>
+#include <set>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -110,6 +111,8 @@ namespace
     int  checkpoint_nfiles;
     int  regrid_on_restart;
     int  use_efficient_regrid;
+    int  incremental_regrid;
+    Real incremental_regrid_efficiency;
     int  plotfile_on_restart;
     int  insitu_on_restart;
     int  checkpoint_on_restart;
@@ -129,6 +132,12 @@ Amr::UsingPrecreateDirectories () noexcept
     return precreateDirectories;
 }
 
+bool
+Amr::UsingIncrementalRegrid () const noexcept
+{
+    return incremental_regrid;
+}
+
 void
 Amr::Initialize ()
 {
@@ -145,6 +154,8 @@ Amr::Initialize ()
     checkpoint_nfiles        = 64;
     regrid_on_restart        = 0;
     use_efficient_regrid     = 0;
+    incremental_regrid       = 0;
+    incremental_regrid_efficiency = 0.9;
     plotfile_on_restart      = 0;
     insitu_on_restart        = 0;
     checkpoint_on_restart    = 0;
@@ -284,6 +295,8 @@ Amr::InitAmr ()
     //
     pp.query("regrid_on_restart",regrid_on_restart);
     pp.query("use_efficient_regrid",use_efficient_regrid);
+    pp.query("incremental_regrid",incremental_regrid);
+    pp.query("incremental_regrid_efficiency",incremental_regrid_efficiency);
     pp.query("plotfile_on_restart",plotfile_on_restart);
     pp.query("insitu_on_restart",insitu_on_restart);
     pp.query("checkpoint_on_restart",checkpoint_on_restart);
@@ -756,6 +769,8 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    finishAsyncCheckPoint();
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -1753,6 +1768,8 @@ Amr::checkPoint ()
     BL_PROFILE_REGION_START("Amr::checkPoint()");
     BL_PROFILE("Amr::checkPoint()");
 
+    finishAsyncCheckPoint();
+
     VisMF::SetNOutFiles(checkpoint_nfiles);
     //
     // In checkpoint files always write out FABs in NATIVE format.
@@ -1903,12 +1920,17 @@ Amr::checkPoint ()
 
 	amrex::Print() << "checkPoint() time = " << dCheckPointTime << " secs." << '\n';
     }
-    ParallelDescriptor::Barrier("Amr::checkPoint::end");
+    if (VisMF::GetAsyncWrite()) {
+      // ---- the data are still being written, rename later
+      async_checkpoint = ckfile;
+    } else {
+      ParallelDescriptor::Barrier("Amr::checkPoint::end");
 
-    if(ParallelDescriptor::IOProcessor()) {
-      std::rename(ckfileTemp.c_str(), ckfile.c_str());
+      if(ParallelDescriptor::IOProcessor()) {
+        std::rename(ckfileTemp.c_str(), ckfile.c_str());
+      }
+      ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
     }
-    ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
 
   }  // end while
 
@@ -1922,6 +1944,26 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+void
+Amr::finishAsyncCheckPoint ()
+{
+    if (async_checkpoint.empty()) {
+        return;
+    }
+
+    BL_PROFILE("Amr::finishAsyncCheckPoint()");
+
+    VisMF::AsyncWait();
+
+    if(ParallelDescriptor::IOProcessor()) {
+      const std::string ckfileTemp(async_checkpoint + ".temp");
+      std::rename(ckfileTemp.c_str(), async_checkpoint.c_str());
+    }
+    ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
+
+    async_checkpoint.clear();
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -2906,6 +2948,12 @@ Amr::regrid (int  lbase,
         if (loadbalance_with_workestimates && !initial) {
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
+        else if (new_dmap[lev].empty() && incremental_regrid && !initial && amr_level[lev]) {
+            new_dmap[lev] = makeIncrementalDistributionMap(lev, new_grid_places[lev]);
+        }
+        else if (new_dmap[lev].empty() && !initial && amr_level[lev]) {
+            new_dmap[lev] = MakeDistributionMap(lev, new_grid_places[lev]);
+        }
         else if (new_dmap[lev].empty()) {
 	    new_dmap[lev].define(new_grid_places[lev]);
 	}
@@ -3037,7 +3085,12 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
         Real navg = static_cast<Real>(ba.size()) / static_cast<Real>(ParallelDescriptor::NProcs());
         int nmax = std::max(std::round(loadbalance_max_fac*navg), std::ceil(navg));
 
-        newdm = DistributionMapping::makeKnapSack(workest, nmax);
+        if (migrationWeight() >= 0.0) {
+            newdm = DistributionMapping::makeKnapSack(workest, boxArray(lev), DistributionMap(lev),
+                                                      migrationWeight(), nmax);
+        } else {
+            newdm = DistributionMapping::makeKnapSack(workest, nmax);
+        }
     }
     else
     {
@@ -3047,6 +3100,92 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
     return newdm;
 }
 
+DistributionMapping
+Amr::makeIncrementalDistributionMap (int lev, const BoxArray& ba) const
+{
+    BL_PROFILE("makeIncrementalDistributionMap()");
+
+    //
+    // Boxes that are also grids of the old level stay on their owner, so
+    // that AmrLevel::FillPatch can copy their data locally.  The other
+    // boxes, largest first, go to the process with the fewest cells.  If
+    // the result is less than amr.incremental_regrid_efficiency times as
+    // efficient as distributing all boxes anew, that is done instead.
+    //
+    const BoxArray&            oldba = boxArray(lev);
+    const DistributionMapping& olddm = DistributionMap(lev);
+
+    Vector<int> pmap(ba.size(), -1);
+    Vector<int> newidx;
+
+    std::vector< std::pair<int,Box> > isects;
+
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        const Box& bx = ba[i];
+        oldba.intersections(bx, isects, true, 0);
+        if (!isects.empty() && oldba[isects[0].first] == bx) {
+            pmap[i] = olddm[isects[0].first];
+        } else {
+            newidx.push_back(i);
+        }
+    }
+
+    const int nprocs = ParallelDescriptor::NProcs();
+
+    std::vector<long> load(nprocs, 0L);
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        if (pmap[i] >= 0) load[pmap[i]] += ba[i].numPts();
+    }
+
+    std::stable_sort(newidx.begin(), newidx.end(),
+                     [&] (int a, int b) { return ba[a].numPts() > ba[b].numPts(); });
+
+    std::set< std::pair<long,int> > byload;
+    for (int p = 0; p < nprocs; ++p) {
+        byload.insert(std::make_pair(load[p], p));
+    }
+    for (int i : newidx)
+    {
+        const int p = byload.begin()->second;
+        byload.erase(byload.begin());
+        load[p] += ba[i].numPts();
+        byload.insert(std::make_pair(load[p], p));
+        pmap[i] = p;
+    }
+
+    DistributionMapping newdm(std::move(pmap));
+    DistributionMapping fulldm = MakeDistributionMap(lev, ba);
+
+    auto efficiency = [&] (const DistributionMapping& dm) -> Real
+    {
+        std::vector<long> cells(nprocs, 0L);
+        long total = 0;
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            cells[dm[i]] += ba[i].numPts();
+            total += ba[i].numPts();
+        }
+        const long cmax = *std::max_element(cells.begin(), cells.end());
+        return static_cast<Real>(total) / (static_cast<Real>(nprocs)*static_cast<Real>(cmax));
+    };
+
+    const Real eff     = efficiency(newdm);
+    const Real fulleff = efficiency(fulldm);
+
+    if (verbose > 0) {
+        amrex::Print() << "Incremental regrid on level " << lev << ": "
+                       << ba.size() - newidx.size() << " of " << ba.size()
+                       << " grids unchanged, efficiency " << eff
+                       << " (" << fulleff << " if distributed anew)\n";
+    }
+
+    if (eff < incremental_regrid_efficiency * fulleff) {
+        return fulldm;
+    }
+
+    return newdm;
+}
+
 void
 Amr::LoadBalanceLevel0 (Real time)
 {
@@ -2173,11 +2173,101 @@ AmrLevel::FillPatch (AmrLevel& amrlevel,
 {
     BL_ASSERT(dcomp+ncomp-1 <= leveldata.nComp());
     BL_ASSERT(boxGrow <= leveldata.nGrow());
+
+    if (boxGrow == 0 && amrlevel.parent->UsingIncrementalRegrid() &&
+        FillPatchIncremental(amrlevel, leveldata, time, index, scomp, ncomp, dcomp))
+    {
+        return;
+    }
+
     FillPatchIterator fpi(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp);
     const MultiFab& mf_fillpatched = fpi.get_mf();
     MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+bool
+AmrLevel::FillPatchIncremental (AmrLevel& amrlevel,
+                                MultiFab& leveldata,
+                                Real      time,
+                                int       index,
+                                int       scomp,
+                                int       ncomp,
+                                int       dcomp)
+{
+    //
+    // Only data of a single time level can be copied as they are.
+    //
+    Vector<MultiFab*> srcdata;
+    Vector<Real>      srctime;
+    amrlevel.state[index].getData(srcdata, srctime, time);
+    if (srcdata.size() != 1) return false;
+
+    BL_PROFILE("AmrLevel::FillPatchIncremental()");
+
+    const MultiFab&            src  = *srcdata[0];
+    const BoxArray&            sba  = src.boxArray();
+    const DistributionMapping& sdm  = src.DistributionMap();
+    const BoxArray&            dba  = leveldata.boxArray();
+    const DistributionMapping& ddm  = leveldata.DistributionMap();
+
+    //
+    // The grids of leveldata that are grids of src on the same process.
+    //
+    Vector<int> srcidx(dba.size(), -1);
+    BoxList     fillbl(dba.ixType());
+    Vector<int> fillpmap, fillidx;
+
+    std::vector< std::pair<int,Box> > isects;
+
+    for (int i = 0, N = dba.size(); i < N; ++i)
+    {
+        const Box& bx = dba[i];
+        sba.intersections(bx, isects, true, 0);
+        if (!isects.empty() && sba[isects[0].first] == bx && sdm[isects[0].first] == ddm[i]) {
+            srcidx[i] = isects[0].first;
+        } else {
+            fillbl.push_back(bx);
+            fillpmap.push_back(ddm[i]);
+            fillidx.push_back(i);
+        }
+    }
+
+    if (fillidx.size() == dba.size()) return false;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(leveldata); mfi.isValid(); ++mfi)
+    {
+        const int j = srcidx[mfi.index()];
+        if (j >= 0) {
+            const Box& bx = mfi.validbox();
+            leveldata[mfi].copy(src[j], bx, scomp, bx, dcomp, ncomp);
+        }
+    }
+
+    //
+    // FillPatch the other grids through aliases of their fabs.  The aliases
+    // cover the ghost cells of leveldata too, so fillmf has as many, but
+    // only its valid cells are filled.
+    //
+    if (!fillidx.empty())
+    {
+        const BoxArray            fillba(std::move(fillbl));
+        const DistributionMapping filldm(std::move(fillpmap));
+        MultiFab fillmf(fillba, filldm, ncomp, leveldata.nGrowVect(), MFInfo().SetAlloc(false));
+        for (MFIter mfi(fillmf); mfi.isValid(); ++mfi) {
+            FArrayBox& dfab = leveldata[fillidx[mfi.index()]];
+            fillmf.setFab(mfi, new FArrayBox(dfab, amrex::make_alias, dcomp, ncomp));
+        }
+
+        FillPatchIterator fpi(amrlevel, fillmf, 0, time, index, scomp, ncomp);
+        MultiFab::Copy(fillmf, fpi.get_mf(), 0, 0, ncomp, 0);
+    }
+
+    return true;
+}
+
 void
 AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
                         MultiFab& leveldata,
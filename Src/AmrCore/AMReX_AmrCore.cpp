@@ -85,7 +85,7 @@ AmrCore::regrid (int lbase, Real time, bool)
 	{
 	    if (new_grids[lev] != grids[lev]) // otherwise nothing
 	    {
-		DistributionMapping new_dmap(new_grids[lev]);
+		DistributionMapping new_dmap = MakeDistributionMap(lev, new_grids[lev]);
 		RemakeLevel(lev, time, new_grids[lev], new_dmap);
 		SetBoxArray(lev, new_grids[lev]);
 		SetDistributionMap(lev, new_dmap);
@@ -63,6 +63,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in, Vector<Int
     check_input            = true;
 
     use_new_chop         = false;
+    distributed_cluster  = false;
+    migration_weight     = -1.0;
     iterate_on_new_grids = true;
 
     ParmParse pp("amr");
@@ -368,6 +370,9 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in, Vector<Int
 
     pp.query("check_input", check_input);
 
+    pp.query("distributed_cluster", distributed_cluster);
+    pp.query("migration_weight", migration_weight);
+
     finest_level = -1;
 
     if (check_input) checkInput();
@@ -382,6 +387,19 @@ AmrMesh::MaxRefRatio (int lev) const noexcept
     return maxval;
 }
 
+DistributionMapping
+AmrMesh::MakeDistributionMap (int lev, const BoxArray& ba) const
+{
+    if (migration_weight >= 0.0 && lev <= finest_level && !grids[lev].empty() && !dmap[lev].empty())
+    {
+        return DistributionMapping::makeMigrationAware(ba, grids[lev], dmap[lev], migration_weight);
+    }
+    else
+    {
+        return DistributionMapping(ba);
+    }
+}
+
 void
 AmrMesh::SetDistributionMap (int lev, const DistributionMapping& dmap_in) noexcept
 {
@@ -687,13 +705,23 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         //
         tags.setVal(p_n_comp[levc],TagBox::CLEAR);
         //
-        // Create initial cluster containing all tagged points.
+        // Create initial cluster containing all tagged points.  With
+        // distributed_cluster, each process clusters only its own tags.
         //
 	Vector<IntVect> tagvec;
-	tags.collate(tagvec);
+        if (distributed_cluster) {
+            tags.local_collate(tagvec);
+        } else {
+            tags.collate(tagvec);
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        long ntags = tagvec.size();
+        if (distributed_cluster) {
+            ParallelDescriptor::ReduceLongSum(ntags);
+        }
+
+        if (ntags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -701,26 +729,41 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             if ( !(useFixedCoarseGrids() && levc<useFixedUpToLevel()) ) {
                 new_finest = std::max(new_finest,levf);
 	    }
-            //
-            // Construct initial cluster.
-            //
-            ClusterList clist(&tagvec[0], tagvec.size());
-            if (use_new_chop)
+            BoxList new_bx;
+            if (tagvec.size() > 0)
             {
-               clist.new_chop(grid_eff);
-            } else {
-               clist.chop(grid_eff);
+                //
+                // Construct initial cluster.
+                //
+                ClusterList clist(&tagvec[0], tagvec.size());
+                if (use_new_chop)
+                {
+                   clist.new_chop(grid_eff);
+                } else {
+                   clist.chop(grid_eff);
+                }
+                BoxDomain bd;
+                bd.add(p_n[levc]);
+                clist.intersect(bd);
+                bd.clear();
+                //
+                // Efficient properly nested Clusters have been constructed
+                // now generate list of grids at level levf.
+                //
+                clist.boxList(new_bx);
+            }
+            if (distributed_cluster)
+            {
+                //
+                // Only the boxes are exchanged.  The tag boxes overlap, so
+                // the clusters of different processes may overlap too.
+                //
+                Vector<Box> all_bx(new_bx.begin(), new_bx.end());
+                amrex::AllGatherBoxes(all_bx);
+                BoxArray ba(BoxList(std::move(all_bx)));
+                ba.removeOverlap();
+                new_bx = ba.boxList();
             }
-            BoxDomain bd;
-            bd.add(p_n[levc]);
-            clist.intersect(bd);
-            bd.clear();
-            //
-            // Efficient properly nested Clusters have been constructed
-            // now generate list of grids at level levf.
-            //
-            BoxList new_bx;
-            clist.boxList(new_bx);
             new_bx.refine(bf_lev[levc]);
             new_bx.simplify();
             BL_ASSERT(new_bx.isDisjoint());
@@ -1,8 +1,13 @@
 
 #include <algorithm>
+#include <memory>
 #include <AMReX_Cluster.H>
 #include <AMReX_BoxDomain.H>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace amrex {
 
 namespace {
@@ -147,6 +152,66 @@ Cluster::minBox () noexcept
     }
 }
 
+namespace {
+//
+// The signature of the tags in each direction: the number of tags in each
+// plane normal to it.  Tags next to each other in the array usually fall
+// in the same plane, so for large clusters the counts are spread over
+// NSIG interleaved copies of each histogram, which keeps consecutive
+// increments from waiting on each other, and summed at the end.
+//
+constexpr int NSIG = 4;
+
+void
+Signatures (const IntVect* ar, long n, const Box& bx, Vector<int>* hist)
+{
+    const IntVect lo  = bx.smallEnd();
+    const IntVect len = bx.size();
+    const int     ns  = (n >= NSIG*len.max()) ? NSIG : 1;
+
+    int* AMREX_RESTRICT h[AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; d++)
+    {
+        hist[d].assign(ns*len[d], 0);
+        h[d] = hist[d].dataPtr() - lo[d];
+    }
+
+    long i = 0;
+    if (ns == NSIG)
+    {
+        for ( ; i+NSIG <= n; i += NSIG)
+        {
+            for (int s = 0; s < NSIG; s++)
+            {
+                const IntVect& iv = ar[i+s];
+                AMREX_D_TERM(h[0][s*len[0] + iv[0]]++;,
+                             h[1][s*len[1] + iv[1]]++;,
+                             h[2][s*len[2] + iv[2]]++;)
+            }
+        }
+    }
+    for ( ; i < n; i++)
+    {
+        const IntVect& iv = ar[i];
+        AMREX_D_TERM(h[0][iv[0]]++;, h[1][iv[1]]++;, h[2][iv[2]]++;)
+    }
+
+    for (int d = 0; d < AMREX_SPACEDIM; d++)
+    {
+        const int nd = len[d];
+        int* AMREX_RESTRICT hd = hist[d].dataPtr();
+        for (int s = 1; s < ns; s++)
+        {
+            const int* AMREX_RESTRICT hs = hd + s*nd;
+            AMREX_PRAGMA_SIMD
+            for (int m = 0; m < nd; m++)
+                hd[m] += hs[m];
+        }
+        hist[d].resize(nd);
+    }
+}
+}
+
 //
 // Finds best cut location in histogram.
 //
@@ -194,8 +259,10 @@ FindCut (const int* hist,
     // finding place where change in second derivative is max.
     //
     Vector<int> dhist(len,0);
+    int* AMREX_RESTRICT dh = dhist.dataPtr();
+    AMREX_PRAGMA_SIMD
     for (i = 1; i < len-1; i++)
-        dhist[i] = hist[i+1] - 2*hist[i] + hist[i-1];
+        dh[i] = hist[i+1] - 2*hist[i] + hist[i-1];
 
     int locmax = -1;
     for (i = 0+MINOFF; i < len-MINOFF; i++)
@@ -261,25 +328,11 @@ Cluster::chop ()
 
     const int* lo       = m_bx.loVect();
     const int* hi       = m_bx.hiVect();
-    IntVect m_bx_length = m_bx.size();
-    const int* len      = m_bx_length.getVect();
     //
     // Compute histogram.
     //
-    int* hist[AMREX_SPACEDIM];
-    for (int n = 0; n < AMREX_SPACEDIM; n++)
-    {
-        hist[n] = new int[len[n]];
-        for (int i = 0; i < len[n]; i++)
-            hist[n][i] = 0;
-    }
-    for (int n = 0; n < m_len; n++)
-    {
-        const int* p = m_ar[n].getVect();
-        AMREX_D_TERM( hist[0][p[0]-lo[0]]++;,
-                hist[1][p[1]-lo[1]]++;,
-                hist[2][p[2]-lo[2]]++; )
-     }
+    Vector<int> hist[AMREX_SPACEDIM];
+    Signatures(m_ar, m_len, m_bx, hist);
     //
     // Find cutpoint and cutstatus in each index direction.
     //
@@ -288,7 +341,7 @@ Cluster::chop ()
     IntVect cut;
     for (int n = 0; n < AMREX_SPACEDIM; n++)
     {
-        cut[n] = FindCut(hist[n], lo[n], hi[n], status[n]);
+        cut[n] = FindCut(hist[n].dataPtr(), lo[n], hi[n], status[n]);
         if (status[n] < mincut)
         {
             mincut = status[n];
@@ -321,9 +374,6 @@ Cluster::chop ()
 
     int nhi = m_len - nlo;
 
-    for (int i = 0; i < AMREX_SPACEDIM; i++)
-        delete [] hist[i];
-
     IntVect* prt_it = std::partition(m_ar, m_ar+m_len, Cut(cut,dir));
 
     BL_ASSERT((prt_it-m_ar) == nlo);
@@ -343,25 +393,11 @@ Cluster::new_chop ()
 
     const int* lo       = m_bx.loVect();
     const int* hi       = m_bx.hiVect();
-    IntVect m_bx_length = m_bx.size();
-    const int* len      = m_bx_length.getVect();
     //
     // Compute histogram.
     //
-    int* hist[AMREX_SPACEDIM];
-    for (int n = 0; n < AMREX_SPACEDIM; n++)
-    {
-        hist[n] = new int[len[n]];
-        for (int i = 0; i < len[n]; i++)
-            hist[n][i] = 0;
-    }
-    for (int n = 0; n < m_len; n++)
-    {
-        const int* p = m_ar[n].getVect();
-        AMREX_D_TERM( hist[0][p[0]-lo[0]]++;,
-             hist[1][p[1]-lo[1]]++;,
-             hist[2][p[2]-lo[2]]++; )
-   }
+    Vector<int> hist[AMREX_SPACEDIM];
+    Signatures(m_ar, m_len, m_bx, hist);
 
     int invalid_dir = -1;
     for (int n_try = 0; n_try < 2; n_try++)
@@ -376,7 +412,7 @@ Cluster::new_chop ()
        {
            if (n != invalid_dir)
            {
-              cut[n] = FindCut(hist[n], lo[n], hi[n], status[n]);
+              cut[n] = FindCut(hist[n].dataPtr(), lo[n], hi[n], status[n]);
               if (status[n] < mincut)
               {
                   mincut = status[n];
@@ -429,9 +465,6 @@ Cluster::new_chop ()
    
        if ( (eff() > oldeff) || (neweff > oldeff) || n_try > 0)
        {
-          for (int i = 0; i < AMREX_SPACEDIM; i++)
-              delete [] hist[i];
-
           return newbox.release();
 
        } else {
@@ -529,37 +562,102 @@ ClusterList::boxList (BoxList& blst) const
     }
 }
 
+namespace {
+//
+// The clusters made by chopping a cluster until it is efficient enough,
+// as a binary tree.  A chop leaves the lower part in the cluster and
+// returns the upper part, so kids[0].c is the same Cluster as c.
+//
+struct ChopNode
+{
+    Cluster*                    c = nullptr;
+    std::unique_ptr<ChopNode[]> kids;   // ---- lo and hi, if c was chopped
+};
+
+//
+// Clusters with fewer tags than this are chopped by the task that made them.
+//
+constexpr long ChopTaskSize = 4096;
+
 void
-ClusterList::chop (Real eff)
+ChopTree (ChopNode* nd, Cluster* c, Real eff, Cluster* (Cluster::*chopper) ())
 {
+    nd->c = c;
 
-    for (std::list<Cluster*>::iterator cli = lst.begin(); cli != lst.end(); )
+    if (c->eff() < eff)
     {
-        if ((*cli)->eff() < eff)
-        {
-            lst.push_back((*cli)->chop());
-        }
-        else
-        {
-            ++cli;
-        }
+        Cluster* hic = (c->*chopper)();
+        nd->kids.reset(new ChopNode[2]);
+        ChopNode* lo = &nd->kids[0];
+        //
+        // The two parts own disjoint pieces of the tag array.
+        //
+#ifdef _OPENMP
+#pragma omp task if (c->numTag() > ChopTaskSize)
+#endif
+        ChopTree(lo, c, eff, chopper);
+
+        ChopTree(&nd->kids[1], hic, eff, chopper);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
     }
 }
+}
+
+void
+ClusterList::chop (Real eff)
+{
+    chop_all(eff, &Cluster::chop);
+}
 
 void
 ClusterList::new_chop (Real eff)
 {
+    chop_all(eff, &Cluster::new_chop);
+}
 
-    for (std::list<Cluster*>::iterator cli = lst.begin(); cli != lst.end(); )
+void
+ClusterList::chop_all (Real eff, Cluster* (Cluster::*chopper) ())
+{
+    //
+    // Chopping a cluster only depends on its own tags, so the clusters are
+    // chopped recursively by OpenMP tasks.
+    //
+    const std::vector<Cluster*> clusters(lst.begin(), lst.end());
+    const int N = clusters.size();
+    std::vector<ChopNode> roots(N);
+
+#ifdef _OPENMP
+#pragma omp parallel if (omp_get_max_threads() > 1)
+#pragma omp single
+#endif
+    for (int i = 0; i < N; i++)
     {
-        if ((*cli)->eff() < eff)
-        {
-            lst.push_back((*cli)->new_chop());
-        }
-        else
+#ifdef _OPENMP
+#pragma omp task
+#endif
+        ChopTree(&roots[i], clusters[i], eff, chopper);
+    }
+    //
+    // Put the clusters in the order of the serial algorithm, which chops
+    // the cluster at the front until it is efficient enough, appending
+    // the upper parts to the end of the list, and then moves on.
+    //
+    std::list<const ChopNode*> order;
+    for (int i = 0; i < N; i++)
+        order.push_back(&roots[i]);
+
+    lst.clear();
+
+    for (std::list<const ChopNode*>::iterator it = order.begin(); it != order.end(); ++it)
+    {
+        while ((*it)->kids)
         {
-            ++cli;
+            order.push_back(&(*it)->kids[1]);
+            *it = &(*it)->kids[0];
         }
+        lst.push_back((*it)->c);
     }
 }
 
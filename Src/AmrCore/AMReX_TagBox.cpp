@@ -2,6 +2,9 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 
 #include <AMReX_TagBox.H>
 #include <AMReX_Geometry.H>
@@ -11,6 +14,140 @@
 
 namespace amrex {
 
+namespace {
+
+//
+// The tags are scanned eight cells at a time as one 64-bit word.
+//
+constexpr std::uint64_t LowBits = 0x0101010101010101ULL;
+
+//! The low bit of every byte of w that is not CLEAR.
+inline std::uint64_t
+nonzero_bytes (std::uint64_t w) noexcept
+{
+    w |= w >> 4;
+    w |= w >> 2;
+    w |= w >> 1;
+    return w & LowBits;
+}
+
+inline int
+popcount (std::uint64_t w) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    int n = 0;
+    for ( ; w; w &= w-1) ++n;
+    return n;
+#endif
+}
+
+inline int
+lowest_bit (std::uint64_t w) noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    int n = 0;
+    for ( ; !(w & 1); w >>= 1) ++n;
+    return n;
+#endif
+}
+
+inline std::uint64_t
+load_word (const TagBox::TagType* p) noexcept
+{
+    std::uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+//! Number of tagged cells among the n cells at p.
+long
+count_row (const TagBox::TagType* p, long n) noexcept
+{
+    long nt = 0;
+    long i = 0;
+    for ( ; i+8 <= n; i += 8) {
+        nt += popcount(nonzero_bytes(load_word(p+i)));
+    }
+    for ( ; i < n; ++i) {
+        if (p[i] != TagBox::CLEAR) ++nt;
+    }
+    return nt;
+}
+
+//
+// A row of cells as a bitset, one bit per cell.
+//
+using BitRow = std::vector<std::uint64_t>;
+
+//! Grow the set bits of row by one cell in both directions.
+void
+dilate_row (BitRow& row, std::uint64_t tailmask) noexcept
+{
+    const int nw = row.size();
+    std::uint64_t carry = 0;
+    for (int w = 0; w < nw; ++w) {
+        const std::uint64_t cur  = row[w];
+        const std::uint64_t next = (w+1 < nw) ? row[w+1] : 0;
+        row[w] = cur | (cur << 1) | carry | (cur >> 1) | (next << 63);
+        carry = cur >> 63;
+    }
+    row[nw-1] &= tailmask;
+}
+
+//
+// Tags sent between processes are runs of cells along the first
+// direction, AMREX_SPACEDIM+1 ints each: the first cell and the length.
+// The tags must be sorted, as RemoveDuplicates leaves them.
+//
+constexpr int RunSize = AMREX_SPACEDIM+1;
+
+void
+encode_runs (const Vector<IntVect>& tags, Vector<int>& runs)
+{
+    runs.clear();
+    for (long n = 0, N = tags.size(); n < N; )
+    {
+        const IntVect& start = tags[n];
+        long m = n+1;
+        IntVect next = start;
+        next[0] += 1;
+        while (m < N && tags[m] == next) {
+            ++m;
+            next[0] += 1;
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            runs.push_back(start[idim]);
+        }
+        runs.push_back(static_cast<int>(m-n));
+        n = m;
+    }
+}
+
+void
+decode_runs (const int* runs, long nints, Vector<IntVect>& tags)
+{
+    BL_ASSERT(nints % RunSize == 0);
+    long ntags = 0;
+    for (long r = 0; r < nints; r += RunSize) {
+        ntags += runs[r+AMREX_SPACEDIM];
+    }
+    tags.resize(ntags);
+    long n = 0;
+    for (long r = 0; r < nints; r += RunSize)
+    {
+        IntVect iv(runs+r);
+        for (int i = 0, len = runs[r+AMREX_SPACEDIM]; i < len; ++i, ++iv[0]) {
+            tags[n++] = iv;
+        }
+    }
+}
+
+}
+
 TagBox::TagBox () noexcept {}
 
 TagBox::TagBox (const Box& bx,
@@ -119,52 +256,93 @@ TagBox::buffer (const IntVect& nbuff, const IntVect& nwid) noexcept
     // Note: this routine assumes cell with TagBox::SET tag are in
     // interior of tagbox (region = grow(domain,-nwid)).
     //
+    // The cells within nbuff of a SET cell are found by dilating a bitset
+    // of the SET cells one direction at a time, so the cost does not grow
+    // with the volume of the buffer.
+    //
     Box inside(domain);
     inside.grow(-nwid);
-    const int* inlo = inside.loVect();
-    const int* inhi = inside.hiVect();
-
-    int klo = 0, khi = 0, jlo = 0, jhi = 0, ilo, ihi;
-    AMREX_D_TERM(ilo=inlo[0]; ihi=inhi[0]; ,
-                 jlo=inlo[1]; jhi=inhi[1]; ,
-                 klo=inlo[2]; khi=inhi[2];)
-
-    int ni = 0, nj = 0, nk = 0;
-    AMREX_D_TERM(ni=nbuff[0];, nj=nbuff[1];, nk=nbuff[2];)
+    if (!inside.ok() || nbuff.max() <= 0) return;
+
+    const IntVect d_length = domain.size();
+    const int nx = d_length[0];
+    int ny = 1, nz = 1;
+    AMREX_D_TERM(, ny = d_length[1]; , nz = d_length[2];)
+    const int nw = (nx+63)/64;
+    const std::uint64_t tailmask = (nx%64 == 0) ? ~std::uint64_t(0)
+                                                : (std::uint64_t(1) << (nx%64)) - 1;
+
+    const IntVect ilo = inside.smallEnd() - domain.smallEnd();
+    const IntVect ihi = inside.bigEnd()   - domain.smallEnd();
+    int klo = 0, khi = 0, jlo = 0, jhi = 0;
+    AMREX_D_TERM(,
+                 jlo=ilo[1]; jhi=ihi[1]; ,
+                 klo=ilo[2]; khi=ihi[2];)
 
-    IntVect d_length = domain.size();
-    const int* len = d_length.getVect();
-    const int* lo = domain.loVect();
     TagType* d = dataPtr();
+    const long nrows = long(ny)*nz;
+    std::vector<BitRow> bits(nrows, BitRow(nw,0));
+
+    bool any = false;
+    for (int k = klo; k <= khi; ++k) {
+        for (int j = jlo; j <= jhi; ++j) {
+            const long r = j + long(k)*ny;
+            const TagType* p = d + r*nx;
+            BitRow& row = bits[r];
+            for (int i = ilo[0]; i <= ihi[0]; ++i) {
+                if (p[i] == TagBox::SET) {
+                    row[i/64] |= std::uint64_t(1) << (i%64);
+                    any = true;
+                }
+            }
+        }
+    }
+    if (!any) return;
 
-#define OFF(i,j,k,lo,len) AMREX_D_TERM(i-lo[0], +(j-lo[1])*len[0] , +(k-lo[2])*len[0]*len[1])
-   
-    for (int k = klo; k <= khi; k++)
+    for (long r = 0; r < nrows; ++r) {
+        for (int n = 0; n < nbuff[0]; ++n) {
+            dilate_row(bits[r], tailmask);
+        }
+    }
+
+    //
+    // Dilate across rows: stride is the distance between neighboring rows
+    // in the direction, n the number of rows and nb the buffer width.
+    //
+    auto dilate_across = [&] (long stride, int n, int nb)
     {
-        for (int j = jlo; j <= jhi; j++)
+        if (nb <= 0 || n <= 1) return;
+        std::vector<BitRow> line(n);
+        for (long r0 = 0; r0 < nrows; ++r0)
         {
-            for (int i = ilo; i <= ihi; i++)
-            {
-                TagType* d_check = d + OFF(i,j,k,lo,len);
-                if (*d_check == TagBox::SET)
-                {
-                    for (int kk = -nk; kk <= nk; kk++)
-                    {
-                        for (int jj = -nj; jj <= nj; jj++)
-                        {
-                            for (int ii = -ni; ii <= ni; ii++)
-                            {
-                                TagType* dn = d_check+ AMREX_D_TERM(ii, +jj*len[0], +kk*len[0]*len[1]);
-                                if (*dn !=TagBox::SET)
-                                    *dn = TagBox::BUF;
-                            }
-                        }
-                    }
+            if ((r0/stride) % n != 0) continue;   // ---- r0 is the first row of a line
+            for (int m = 0; m < n; ++m) line[m] = bits[r0+m*stride];
+            for (int m = 0; m < n; ++m) {
+                BitRow& out = bits[r0+m*stride];
+                for (int mm = std::max(0,m-nb); mm <= std::min(n-1,m+nb); ++mm) {
+                    for (int w = 0; w < nw; ++w) out[w] |= line[mm][w];
                 }
             }
         }
+    };
+#if (AMREX_SPACEDIM > 1)
+    dilate_across(1, ny, nbuff[1]);
+#endif
+#if (AMREX_SPACEDIM > 2)
+    dilate_across(ny, nz, nbuff[2]);
+#endif
+
+    for (long r = 0; r < nrows; ++r)
+    {
+        TagType* p = d + r*nx;
+        const BitRow& row = bits[r];
+        for (int w = 0; w < nw; ++w) {
+            for (std::uint64_t b = row[w]; b; b &= b-1) {
+                TagType& t = p[w*64 + lowest_bit(b)];
+                if (t != TagBox::SET) t = TagBox::BUF;
+            }
+        }
     }
-#undef OFF
 }
 
 void 
@@ -199,14 +377,23 @@ TagBox::merge (const TagBox& src) noexcept
         {
             for (int j = jlo; j <= jhi; j++)
             {
-                for (int i = ilo; i <= ihi; i++)
+                const TagType* ds = ds0 + OFF(ilo,j,k,slo,sleng);
+                TagType*       dd = dd0 + OFF(ilo,j,k,dlo,dleng);
+                const int      n  = ihi-ilo+1;
+                int            i  = 0;
+                for ( ; i+8 <= n; i += 8)
                 {
-                    const TagType* ds = ds0 + OFF(i,j,k,slo,sleng);
-                    if (*ds != TagBox::CLEAR)
+                    const std::uint64_t m = nonzero_bytes(load_word(ds+i));
+                    if (m)
                     {
-                        TagType* dd = dd0 + OFF(i,j,k,dlo,dleng);
-                        *dd = TagBox::SET;
-                    }            
+                        std::uint64_t w = load_word(dd+i);
+                        w = (w & ~(m*0xff)) | (m*TagBox::SET);
+                        std::memcpy(dd+i, &w, sizeof(w));
+                    }
+                }
+                for ( ; i < n; ++i)
+                {
+                    if (ds[i] != TagBox::CLEAR) dd[i] = TagBox::SET;
                 }
             }
         }
@@ -217,23 +404,39 @@ TagBox::merge (const TagBox& src) noexcept
 long
 TagBox::numTags () const noexcept
 {
-    long nt = 0L;
-    long len = domain.numPts();
-    const TagType* d = dataPtr();
-    for (long n = 0; n < len; ++n)
-    {
-	if (d[n] != TagBox::CLEAR)
-	    ++nt;
-    }
-    return nt;
+    return count_row(dataPtr(), domain.numPts());
 }
 
 long
 TagBox::numTags (const Box& b) const noexcept
 {
-   TagBox tempTagBox(b,1);
-   tempTagBox.copy(*this);
-   return tempTagBox.numTags();
+    const Box& bx = b & domain;
+    if (!bx.ok()) return 0L;
+
+    const IntVect d_length = domain.size();
+    const int* len = d_length.getVect();
+    const int* dlo = domain.loVect();
+    const int* lo  = bx.loVect();
+    const int* hi  = bx.hiVect();
+    const TagType* d = dataPtr();
+
+    int klo = 0, khi = 0, jlo = 0, jhi = 0;
+    AMREX_D_TERM(,
+                 jlo=lo[1]; jhi=hi[1]; ,
+                 klo=lo[2]; khi=hi[2];)
+
+    long nt = 0L;
+    for (int k = klo; k <= khi; k++)
+    {
+        for (int j = jlo; j <= jhi; j++)
+        {
+            const TagType* p = d + AMREX_D_TERM(lo[0]-dlo[0],
+                                                +(j-dlo[1])*len[0],
+                                                +(k-dlo[2])*len[0]*len[1]);
+            nt += count_row(p, bx.length(0));
+        }
+    }
+    return nt;
 }
 
 long
@@ -256,10 +459,23 @@ TagBox::collate (Vector<IntVect>& ar, int start) const noexcept
     {
         for (int j = 0; j < nj; j++)
         {
-            for (int i = 0; i < ni; i++)
+            const TagType* row = d + AMREX_D_TERM(0, +j*len[0], +k*len[0]*len[1]);
+            int i = 0;
+            for ( ; i+8 <= ni; i += 8)
+            {
+                if (nonzero_bytes(load_word(row+i)) == 0) continue;
+                for (int ii = i; ii < i+8; ii++)
+                {
+                    if (row[ii] != TagBox::CLEAR)
+                    {
+                        ar[start++] = IntVect(AMREX_D_DECL(lo[0]+ii,lo[1]+j,lo[2]+k));
+                        count++;
+                    }
+                }
+            }
+            for ( ; i < ni; i++)
             {
-                const TagType* dn = d + AMREX_D_TERM(i, +j*len[0], +k*len[0]*len[1]);
-                if (*dn != TagBox::CLEAR)
+                if (row[i] != TagBox::CLEAR)
                 {
                     ar[start++] = IntVect(AMREX_D_DECL(lo[0]+i,lo[1]+j,lo[2]+k));
                     count++;
@@ -513,9 +729,9 @@ TagBoxArray::numTags () const
 }
 
 void
-TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Vector<IntVect>& TheLocalCollateSpace) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
+    BL_PROFILE("TagBoxArray::local_collate()");
 
     long count = 0;
 
@@ -527,10 +743,7 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
         count += get(fai).numTags();
     }
 
-    //
-    // Local space for holding just those tags we want to gather to the root cpu.
-    //
-    Vector<IntVect> TheLocalCollateSpace(count);
+    TheLocalCollateSpace.resize(count);
 
     count = 0;
 
@@ -543,8 +756,22 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
     if (count > 0)
     {
         amrex::RemoveDuplicates(TheLocalCollateSpace);
-	count = TheLocalCollateSpace.size();
     }
+}
+
+void
+TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+    //
+    // Local space for holding just those tags we want to gather to the root cpu.
+    //
+    Vector<IntVect> TheLocalCollateSpace;
+    local_collate(TheLocalCollateSpace);
+
+    long count = TheLocalCollateSpace.size();
+
     //
     // The total number of tags system wide that must be collated.
     // This is really just an estimate of the upper bound due to duplicates.
@@ -564,44 +791,55 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
     //
     // Each CPU needs an identical copy since they all must go through grid_places() which isn't parallelized.
 
-    TheGlobalCollateSpace.resize(numtags);
-
 #ifdef BL_USE_MPI
     //
-    // Tell root CPU how many tags each CPU will be sending.
+    // The tags are sent as runs along the first direction, which for
+    // clustered tags is a small fraction of one IntVect per tag.
+    //
+    Vector<int> runs;
+    encode_runs(TheLocalCollateSpace, runs);
+    Vector<IntVect>().swap(TheLocalCollateSpace);
+
+    //
+    // Tell root CPU how many ints each CPU will be sending.
     //
     const int IOProcNumber = ParallelDescriptor::IOProcessorNumber();
-    count *= AMREX_SPACEDIM;  // Convert from count of tags to count of integers to expect.
-    const std::vector<long>& countvec = ParallelDescriptor::Gather(count, IOProcNumber);
-    
+    long nints = runs.size();
+    const std::vector<long>& countvec = ParallelDescriptor::Gather(nints, IOProcNumber);
+
     std::vector<long> offset(countvec.size(),0L);
+    long totints = 0;
     if (ParallelDescriptor::IOProcessor())
     {
         for (int i = 1, N = offset.size(); i < N; i++) {
 	    offset[i] = offset[i-1] + countvec[i-1];
 	}
+        totints = offset.back() + countvec.back();
     }
     //
-    // Gather all the tags to IOProcNumber into TheGlobalCollateSpace.
+    // Gather all the runs to IOProcNumber.
     //
-    BL_ASSERT(sizeof(IntVect) == AMREX_SPACEDIM * sizeof(int));
-    const int* psend = (count > 0) ? TheLocalCollateSpace[0].getVect() : 0;
-    int* precv = TheGlobalCollateSpace[0].getVect();
-    ParallelDescriptor::Gatherv(psend, count,
-				precv, countvec, offset, IOProcNumber); 
+    Vector<int> allruns(std::max(totints,1L));
+    ParallelDescriptor::Gatherv(runs.dataPtr(), nints,
+				allruns.dataPtr(), countvec, offset, IOProcNumber); 
 
     if (ParallelDescriptor::IOProcessor())
     {
+        decode_runs(allruns.dataPtr(), totints, TheGlobalCollateSpace);
         amrex::RemoveDuplicates(TheGlobalCollateSpace);
-	numtags = TheGlobalCollateSpace.size();
+        encode_runs(TheGlobalCollateSpace, runs);
+        nints = runs.size();
     }
 
     //
     // Now broadcast them back to the other processors.
     //
-    ParallelDescriptor::Bcast(&numtags, 1, IOProcNumber);
-    ParallelDescriptor::Bcast(TheGlobalCollateSpace[0].getVect(), numtags*AMREX_SPACEDIM, IOProcNumber);
-    TheGlobalCollateSpace.resize(numtags);
+    ParallelDescriptor::Bcast(&nints, 1, IOProcNumber);
+    runs.resize(nints);
+    ParallelDescriptor::Bcast(runs.dataPtr(), nints, IOProcNumber);
+    if (!ParallelDescriptor::IOProcessor()) {
+        decode_runs(runs.dataPtr(), nints, TheGlobalCollateSpace);
+    }
 
 #else
     //
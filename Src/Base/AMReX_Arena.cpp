@@ -25,6 +25,21 @@ namespace {
     bool use_buddy_allocator = false;
     long buddy_allocator_size = 0L;
     long the_arena_init_size = 0L;
+    bool the_arena_thread_cache = false;
+    long thread_cache_max_size = 4L*1024L*1024L;
+    long thread_cache_max_bytes = 32L*1024L*1024L;
+
+    void PrintFreeList (const char* name, CArena* p, int IOProc)
+    {
+        std::size_t free_bytes, largest, nblocks;
+        p->freeListStats(free_bytes, largest, nblocks);
+        long nfree = static_cast<long>(nblocks);
+        Real frag = static_cast<Real>(p->fragmentation());
+        ParallelDescriptor::ReduceLongMax(nfree, IOProc);
+        ParallelDescriptor::ReduceRealMax(frag, IOProc);
+        amrex::Print() << name << " free blocks (max): " << nfree
+                       << ", fragmentation (max): " << frag << "\n";
+    }
 }
 
 const unsigned int Arena::align_size;
@@ -105,6 +120,15 @@ Arena::Initialize ()
     pp.query("use_buddy_allocator", use_buddy_allocator);
     pp.query("buddy_allocator_size", buddy_allocator_size);
     pp.query("the_arena_init_size", the_arena_init_size);
+    pp.query("the_arena_thread_cache", the_arena_thread_cache);
+    pp.query("thread_cache_max_size", thread_cache_max_size);
+    pp.query("thread_cache_max_bytes", thread_cache_max_bytes);
+
+    ArenaInfo the_arena_info = ArenaInfo().SetPreferred();
+    if (the_arena_thread_cache) {
+        the_arena_info.SetThreadCache(static_cast<std::size_t>(thread_cache_max_size),
+                                      static_cast<std::size_t>(thread_cache_max_bytes));
+    }
 
 #ifdef AMREX_USE_GPU
     if (use_buddy_allocator)
@@ -120,7 +144,7 @@ Arena::Initialize ()
 #endif
     {
 #if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
-        the_arena = new CArena(0, ArenaInfo().SetPreferred());
+        the_arena = new CArena(0, the_arena_info);
 #ifdef AMREX_USE_GPU
         if (the_arena_init_size <= 0) {
             the_arena_init_size = Gpu::Device::totalGlobalMem() / 4L * 3L;
@@ -129,7 +153,12 @@ Arena::Initialize ()
         the_arena->free(p);
 #endif
 #else
-        the_arena = new BArena;
+        // The thread caches sit in front of a coalescing arena.
+        if (the_arena_thread_cache) {
+            the_arena = new CArena(0, the_arena_info);
+        } else {
+            the_arena = new BArena;
+        }
 #endif
     }
 
@@ -210,6 +239,16 @@ Arena::PrintUsage ()
 #else
             amrex::Print() << "[The         Arena] space (MB): " << min_megabytes << "\n";
 #endif
+            PrintFreeList("[The         Arena]", p, IOProc);
+            if (p->hasThreadCache()) {
+                long stats[2];
+                p->threadCacheStats(stats[0], stats[1]);
+                ParallelDescriptor::ReduceLongSum(stats, 2, IOProc);
+                const long total = stats[0] + stats[1];
+                amrex::Print() << "[The         Arena] thread cache hits: " << stats[0]
+                               << " of " << total << " allocations ("
+                               << (total > 0 ? (100.*stats[0])/total : 0.) << "%)\n";
+            }
         }
     }
     if (The_Device_Arena()) {
@@ -225,6 +264,7 @@ Arena::PrintUsage ()
 #else
             amrex::Print() << "[The  Device Arena] space (MB): " << min_megabytes << "\n";
 #endif
+            PrintFreeList("[The  Device Arena]", p, IOProc);
         }
     }
     if (The_Managed_Arena()) {
@@ -240,6 +280,7 @@ Arena::PrintUsage ()
 #else
             amrex::Print() << "[The Managed Arena] space (MB): " << min_megabytes << "\n";
 #endif
+            PrintFreeList("[The Managed Arena]", p, IOProc);
         }
     }
     if (The_Pinned_Arena()) {
@@ -255,6 +296,7 @@ Arena::PrintUsage ()
 #else
             amrex::Print() << "[The  Pinned Arena] space (MB): " << min_megabytes << "\n";
 #endif
+            PrintFreeList("[The  Pinned Arena]", p, IOProc);
         }
     }
 }
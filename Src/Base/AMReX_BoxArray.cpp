@@ -5,6 +5,10 @@
 #include <AMReX_Utility.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_BaseFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <numeric>
 
 #ifdef BL_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
@@ -26,6 +30,7 @@ long BARef::total_hash_bytes_hwm = 0L;
 #endif
 
 bool    BARef::initialized = false;
+bool    BARef::use_bvh     = false;
 bool BoxArray::initialized = false;
 
 namespace {
@@ -87,6 +92,7 @@ BARef::~BARef ()
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
 #endif	    
 }
 
@@ -178,10 +184,14 @@ BARef::resize (long n) {
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(-1);
     updateMemoryUsage_hash(-1);
+    updateMemoryUsage_bvh(-1);
 #endif
     m_abox.resize(n);
     hash.clear();
     has_hashmap = false;
+    bvh.clear();
+    bvh_index.clear();
+    has_bvh = false;
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif
@@ -222,6 +232,20 @@ BARef::updateMemoryUsage_hash (int s)
 	}
     }
 }
+
+void
+BARef::updateMemoryUsage_bvh (int s)
+{
+    if (bvh.size() > 0) {
+	long b = amrex::bytesOf(bvh) + amrex::bytesOf(bvh_index);
+	if (s > 0) {
+	    total_hash_bytes += b;
+	    total_hash_bytes_hwm = std::max(total_hash_bytes_hwm, total_hash_bytes);
+	} else {
+	    total_hash_bytes -= b;
+	}
+    }
+}
 #endif
 
 void
@@ -260,6 +284,18 @@ BoxArray::Initialize ()
     if (!initialized) {
 	initialized = true;
 	BARef::Initialize();
+
+        ParmParse pp("boxarray");
+        std::string index;
+        if (pp.query("index", index)) {
+            if (index == "bvh") {
+                BARef::use_bvh = true;
+            } else if (index == "hash") {
+                BARef::use_bvh = false;
+            } else {
+                amrex::Abort("BoxArray::Initialize: boxarray.index must be hash or bvh");
+            }
+        }
     }
 
     amrex::ExecOnFinalize(BoxArray::Finalize);
@@ -1104,6 +1140,11 @@ BoxArray::intersections (const Box&                         bx,
 {
   // This is called too many times BL_PROFILE("BoxArray::intersections()");
 
+    if (BARef::use_bvh && !m_ref->HasHashMap()) {
+        intersections_bvh(bx, isects, first_only, ng);
+        return;
+    }
+
     BARef::HashType& BoxHashMap = getHashMap();
 
     isects.resize(0);
@@ -1172,7 +1213,26 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
     bl.set(bx.ixType());
     bl.push_back(bx);
 
-    if (!empty()) 
+    if (!empty() && BARef::use_bvh && !m_ref->HasHashMap())
+    {
+        std::vector< std::pair<int,Box> > isects;
+        intersections_bvh(bx, isects, false, IntVect::TheZeroVector());
+
+        BoxList newbl(bl.ixType());
+        newbl.reserve(bl.capacity());
+        BoxList newdiff(bl.ixType());
+
+        for (int i = 0, N = isects.size(); i < N && bl.isNotEmpty(); ++i)
+        {
+            newbl.clear();
+            for (const Box& b : bl) {
+                amrex::boxDiff(newdiff, b, isects[i].second);
+                newbl.join(newdiff);
+            }
+            bl.swap(newbl);
+        }
+    }
+    else if (!empty()) 
     {
 	BARef::HashType& BoxHashMap = getHashMap();
 
@@ -1245,6 +1305,15 @@ BoxArray::clear_hash_bin () const
         m_ref->hash.clear();
         m_ref->has_hashmap = false;
     }
+    if (!m_ref->bvh.empty())
+    {
+#ifdef BL_MEM_PROFILING
+	m_ref->updateMemoryUsage_bvh(-1);
+#endif
+        m_ref->bvh.clear();
+        m_ref->bvh_index.clear();
+        m_ref->has_bvh = false;
+    }
 }
 
 //
@@ -1263,7 +1332,8 @@ BoxArray::removeOverlap (bool simplify)
 
     uniqify();
 
-    BARef::HashType& BoxHashMap = m_ref->hash;
+    // ---- new boxes are added to the index below, which only the hash supports
+    BARef::HashType& BoxHashMap = getHashMap();
 
     const Box EmptyBox;
 
@@ -1408,6 +1478,160 @@ BoxArray::getHashMap () const
     return BoxHashMap;
 }
 
+namespace {
+
+constexpr int BVHLeafSize = 4;
+
+//
+// Build the subtree of bvh_index[begin:end) by splitting at the median
+// of the box centers along their longest spread, so the tree is balanced
+// and built in O(n log n).
+//
+void
+build_bvh (Vector<BARef::BVHNode>& nodes, int* index, const Vector<Box>& abox,
+           int begin, int end)
+{
+    const int me = nodes.size();
+    nodes.push_back(BARef::BVHNode());
+
+    IntVect lo = abox[index[begin]].smallEnd();
+    IntVect hi = abox[index[begin]].bigEnd();
+    IntVect clo = lo + hi;  // ---- twice the centers
+    IntVect chi = clo;
+    for (int i = begin+1; i < end; ++i) {
+        const Box& b = abox[index[i]];
+        lo.min(b.smallEnd());
+        hi.max(b.bigEnd());
+        const IntVect c = b.smallEnd() + b.bigEnd();
+        clo.min(c);
+        chi.max(c);
+    }
+
+    if (end - begin > BVHLeafSize)
+    {
+        const int dir = (chi - clo).maxDir(false);
+        const int mid = (begin + end) / 2;
+        std::nth_element(index+begin, index+mid, index+end,
+                         [&abox,dir] (int a, int b) {
+                             return abox[a].smallEnd(dir) + abox[a].bigEnd(dir)
+                                 <  abox[b].smallEnd(dir) + abox[b].bigEnd(dir);
+                         });
+        build_bvh(nodes, index, abox, begin, mid);
+        build_bvh(nodes, index, abox, mid, end);
+    }
+
+    BARef::BVHNode& node = nodes[me];
+    node.lo    = lo;
+    node.hi    = hi;
+    node.begin = begin;
+    node.end   = end;
+    node.next  = nodes.size();
+}
+
+}
+
+const Vector<BARef::BVHNode>&
+BoxArray::getBVH () const
+{
+    Vector<BARef::BVHNode>& nodes = m_ref->bvh;
+
+    if (m_ref->HasBVH()) return nodes;
+
+#ifdef _OPENMP
+    #pragma omp critical(intersections_lock)
+#endif
+    {
+        if (nodes.empty() && size() > 0)
+        {
+            const int N = size();
+            Vector<int>& index = m_ref->bvh_index;
+            index.resize(N);
+            std::iota(index.begin(), index.end(), 0);
+
+            nodes.reserve(2*(N/BVHLeafSize+1));
+            build_bvh(nodes, index.data(), m_ref->m_abox, 0, N);
+
+            m_ref->has_bvh = true;
+
+#ifdef BL_MEM_PROFILING
+	    m_ref->updateMemoryUsage_bvh(1);
+#endif
+        }
+    }
+
+    return nodes;
+}
+
+void
+BoxArray::intersections_bvh (const Box&                         bx,
+                             std::vector< std::pair<int,Box> >& isects,
+                             bool                               first_only,
+                             const IntVect&                     ng) const
+{
+    const Vector<BARef::BVHNode>& nodes = getBVH();
+
+    isects.resize(0);
+
+    if (nodes.empty()) return;
+
+    BL_ASSERT(bx.ixType() == ixType());
+
+    //
+    // The query box in the index space of the stored boxes, as for the hash.
+    //
+    Box gbx = amrex::grow(bx,ng);
+
+    IntVect glo = gbx.smallEnd();
+    IntVect ghi = gbx.bigEnd();
+    const IntVect& doilo = getDoiLo();
+    const IntVect& doihi = getDoiHi();
+
+    gbx.setSmall(glo - doihi).setBig(ghi + doilo);
+    // ---- the cells covered, so refine as cell-centered
+    Box qbx(gbx.smallEnd(), gbx.bigEnd());
+    qbx.refine(m_crse_ratio);
+
+    const IntVect& qlo = qbx.smallEnd();
+    const IntVect& qhi = qbx.bigEnd();
+
+    bool super_simple = m_simple && m_crse_ratio==1 && m_typ.cellCentered();
+    const auto& abox = m_ref->m_abox;
+    const auto& index = m_ref->bvh_index;
+
+    for (int inode = 0, nnodes = nodes.size(); inode < nnodes; )
+    {
+        const BARef::BVHNode& node = nodes[inode];
+
+        if (qlo.allLE(node.hi) && node.lo.allLE(qhi))
+        {
+            if (node.next == inode+1)  // ---- a leaf
+            {
+                for (int k = node.begin; k < node.end; ++k)
+                {
+                    const int i = index[k];
+                    const Box& abx = abox[i];
+                    if (qlo.allLE(abx.bigEnd()) && abx.smallEnd().allLE(qhi))
+                    {
+                        const Box& ibox = super_simple ? abx : (*this)[i];
+                        const Box& isect = bx & amrex::grow(ibox,ng);
+
+                        if (isect.ok())
+                        {
+                            isects.push_back(std::pair<int,Box>(i,isect));
+                            if (first_only) return;
+                        }
+                    }
+                }
+            }
+            ++inode;
+        }
+        else
+        {
+            inode = node.next;
+        }
+    }
+}
+
 void
 BoxArray::uniqify ()
 {
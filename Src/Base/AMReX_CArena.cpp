@@ -1,6 +1,9 @@
 
 #include <utility>
 #include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
 
 #include <AMReX_CArena.H>
 #include <AMReX_BLassert.H>
@@ -8,6 +11,41 @@
 
 namespace amrex {
 
+namespace {
+
+std::atomic<long> carena_count{0};
+
+//
+// Size classes of the thread caches.  Requests up to 64 bytes are rounded to
+// multiples of 16 bytes; above that every power of two is split into four
+// classes, so rounding wastes at most a quarter of a block.
+//
+int
+tcache_class (std::size_t nbytes, std::size_t& class_size) noexcept
+{
+    if (nbytes <= 64) {
+        class_size = (nbytes+15)/16*16;
+        return static_cast<int>(class_size/16) - 1;
+    }
+    int p = 6;
+    while ((std::size_t(1) << (p+1)) < nbytes) ++p;
+    const std::size_t step = std::size_t(1) << (p-2);
+    const std::size_t n = (nbytes+step-1)/step;
+    class_size = n*step;
+    return 4 + (p-6)*4 + static_cast<int>(n) - 5;
+}
+
+std::size_t
+tcache_class_size (int c) noexcept
+{
+    if (c < 4) return static_cast<std::size_t>(c+1)*16;
+    const int p = 6 + (c-4)/4;
+    const std::size_t step = std::size_t(1) << (p-2);
+    return static_cast<std::size_t>((c-4)%4 + 5) * step;
+}
+
+}
+
 CArena::CArena (std::size_t hunk_size, ArenaInfo info)
 {
     arena_info = info;
@@ -19,6 +57,16 @@ CArena::CArena (std::size_t hunk_size, ArenaInfo info)
 
     BL_ASSERT(m_hunk >= hunk_size);
     BL_ASSERT(m_hunk%Arena::align_size == 0);
+
+    if (info.use_thread_cache && info.thread_cache_max_size > 0)
+    {
+        std::size_t max_size;
+        m_tcache_nclasses = tcache_class(Arena::align(info.thread_cache_max_size), max_size) + 1;
+        m_tcache_max_size = max_size;
+        m_tcache_max_bytes = std::max(info.thread_cache_max_bytes, max_size);
+        m_tcache_id = ++carena_count;
+        m_use_tcache = true;
+    }
 }
 
 CArena::~CArena ()
@@ -31,19 +79,49 @@ CArena::~CArena ()
 void*
 CArena::alloc (std::size_t nbytes)
 {
+    if (m_use_tcache && nbytes <= m_tcache_max_size)
+    {
+        std::size_t class_size;
+        const int c = tcache_class(nbytes == 0 ? 1 : nbytes, class_size);
+
+        ThreadCache& tc = thread_cache();
+        std::vector<void*>& bin = tc.bins[c];
+        if (!bin.empty()) {
+            void* vp = bin.back();
+            bin.pop_back();
+            tc.bytes -= class_size;
+            ++tc.hits;
+            return vp;
+        }
+        ++tc.misses;
+
+        void* vp;
+        {
+            std::lock_guard<std::mutex> lock(carena_mutex);
+            vp = alloc_locked(class_size);
+        }
+        ThreadCacheShard& shard = tcache_shard(vp);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.classes[vp] = c;
+        return vp;
+    }
+
     std::lock_guard<std::mutex> lock(carena_mutex);
+    return alloc_locked(nbytes);
+}
 
+void*
+CArena::alloc_locked (std::size_t nbytes)
+{
     nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
     //
-    // Find node in freelist at lowest memory address that'll satisfy request.
+    // Find the smallest free block that'll satisfy request.  Among blocks of
+    // that size, take the one at the lowest memory address.
     //
-    NL::iterator free_it = m_freelist.begin();
+    SL::iterator size_it = m_sizelist.lower_bound(std::make_pair(nbytes, static_cast<void*>(0)));
 
-    for ( ; free_it != m_freelist.end(); ++free_it) {
-        if ((*free_it).size() >= nbytes) {
-            break;
-        }
-    }
+    NL::iterator free_it = (size_it == m_sizelist.end())
+        ? m_freelist.end() : m_freelist.find(Node(size_it->second, 0, 0));
 
     void* vp = 0;
 
@@ -67,6 +145,7 @@ CArena::alloc (std::size_t nbytes)
             void* block = static_cast<char*>(vp) + nbytes;
 
             m_freelist.insert(m_freelist.end(), Node(block, vp, m_hunk-nbytes));
+            m_sizelist.insert(std::make_pair(m_hunk-nbytes, block));
         }
 
         m_busylist.insert(Node(vp, vp, nbytes));
@@ -74,10 +153,12 @@ CArena::alloc (std::size_t nbytes)
     else
     {
         BL_ASSERT((*free_it).size() >= nbytes);
+        BL_ASSERT((*free_it).size() == size_it->first);
         BL_ASSERT(m_busylist.find(*free_it) == m_busylist.end());
 
         vp = (*free_it).block();
         m_busylist.insert(Node(vp, free_it->owner(), nbytes));
+        m_sizelist.erase(size_it);
 
         if ((*free_it).size() > nbytes)
         {
@@ -93,6 +174,7 @@ CArena::alloc (std::size_t nbytes)
             freeblock.block(static_cast<char*>(vp) + nbytes);
 
             m_freelist.insert(free_it, freeblock);
+            m_sizelist.insert(std::make_pair(freeblock.size(), freeblock.block()));
         }
 
         m_freelist.erase(free_it);
@@ -106,13 +188,49 @@ CArena::alloc (std::size_t nbytes)
 void
 CArena::free (void* vp)
 {
-    std::lock_guard<std::mutex> lock(carena_mutex);
-
     if (vp == 0)
         //
         // Allow calls with NULL as allowed by C++ delete.
         //
         return;
+
+    if (m_use_tcache)
+    {
+        int c = -1;
+        {
+            ThreadCacheShard& shard = tcache_shard(vp);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.classes.find(vp);
+            if (it != shard.classes.end()) c = it->second;
+        }
+        if (c >= 0)
+        {
+            //
+            // Keep the block in this thread's cache.  It may have been
+            // allocated by another thread; that is fine.
+            //
+            ThreadCache& tc = thread_cache();
+            std::vector<void*>& bin = tc.bins[c];
+            bin.push_back(vp);
+            tc.bytes += tcache_class_size(c);
+            if (tc.bytes > m_tcache_max_bytes) {
+                for (int ic = 0; ic < m_tcache_nclasses; ++ic) {
+                    tcache_flush_bin(tc, ic, 0);
+                }
+            } else if (bin.size() > ThreadCacheBinSize) {
+                tcache_flush_bin(tc, c, ThreadCacheBinSize/2);
+            }
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(carena_mutex);
+    free_locked(vp);
+}
+
+void
+CArena::free_locked (void* vp)
+{
     //
     // `vp' had better be in the busy list.
     //
@@ -160,6 +278,7 @@ CArena::free (void* vp)
             //
             Node* node = const_cast<Node*>(&(*lo_it));
             BL_ASSERT(!(node == 0));
+            m_sizelist.erase(std::make_pair(node->size(), node->block()));
             node->size((*lo_it).size() + (*free_it).size());
             m_freelist.erase(free_it);
             free_it = lo_it;
@@ -177,9 +296,14 @@ CArena::free (void* vp)
         //
         Node* node = const_cast<Node*>(&(*free_it));
         BL_ASSERT(!(node == 0));
+        m_sizelist.erase(std::make_pair(hi_it->size(), hi_it->block()));
         node->size((*free_it).size() + (*hi_it).size());
         m_freelist.erase(hi_it);
     }
+    //
+    // The size index gets the block only after it has been coalesced.
+    //
+    m_sizelist.insert(std::make_pair(free_it->size(), free_it->block()));
 }
 
 std::size_t
@@ -188,4 +312,97 @@ CArena::heap_space_used () const noexcept
     return m_used;
 }
 
+void
+CArena::freeListStats (std::size_t& free_bytes, std::size_t& largest,
+                       std::size_t& nblocks)
+{
+    std::lock_guard<std::mutex> lock(carena_mutex);
+
+    free_bytes = 0;
+    for (auto const& node : m_freelist) {
+        free_bytes += node.size();
+    }
+    largest = m_sizelist.empty() ? 0 : m_sizelist.rbegin()->first;
+    nblocks = m_freelist.size();
+}
+
+double
+CArena::fragmentation ()
+{
+    std::size_t free_bytes, largest, nblocks;
+    freeListStats(free_bytes, largest, nblocks);
+    return (free_bytes > 0) ? 1.0 - double(largest)/double(free_bytes) : 0.0;
+}
+
+CArena::ThreadCache&
+CArena::thread_cache ()
+{
+    //
+    // Each thread keeps (arena id, cache) pairs for the arenas it has used.
+    // Ids are never reused, so entries of deleted arenas are never matched.
+    //
+    static thread_local std::vector<std::pair<long,ThreadCache*> > tl_caches;
+    for (auto const& kv : tl_caches) {
+        if (kv.first == m_tcache_id) return *kv.second;
+    }
+
+    ThreadCache* tc;
+    {
+        std::lock_guard<std::mutex> lock(carena_mutex);
+        m_tcaches.emplace_back(new ThreadCache(m_tcache_nclasses));
+        tc = m_tcaches.back().get();
+    }
+    tl_caches.emplace_back(m_tcache_id, tc);
+    return *tc;
+}
+
+CArena::ThreadCacheShard&
+CArena::tcache_shard (void* p) noexcept
+{
+    const std::uintptr_t i = reinterpret_cast<std::uintptr_t>(p) / Arena::align_size;
+    return m_tcache_shards[i % ThreadCacheNShards];
+}
+
+void
+CArena::tcache_flush_bin (ThreadCache& tc, int c, std::size_t first)
+{
+    std::vector<void*>& bin = tc.bins[c];
+    if (bin.size() <= first) return;
+
+    for (std::size_t i = first; i < bin.size(); ++i) {
+        ThreadCacheShard& shard = tcache_shard(bin[i]);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.classes.erase(bin[i]);
+    }
+    {
+        std::lock_guard<std::mutex> lock(carena_mutex);
+        for (std::size_t i = first; i < bin.size(); ++i) {
+            free_locked(bin[i]);
+        }
+    }
+    tc.bytes -= (bin.size()-first) * tcache_class_size(c);
+    bin.resize(first);
+}
+
+void
+CArena::threadCacheStats (long& hits, long& misses) const
+{
+    hits = 0;
+    misses = 0;
+    for (auto const& tc : m_tcaches) {
+        hits += tc->hits;
+        misses += tc->misses;
+    }
+}
+
+void
+CArena::flushThreadCaches ()
+{
+    for (auto& tc : m_tcaches) {
+        for (int c = 0; c < m_tcache_nclasses; ++c) {
+            tcache_flush_bin(*tc, c, 0);
+        }
+    }
+}
+
 }
@@ -18,6 +18,7 @@
 #include <map>
 #include <vector>
 #include <queue>
+#include <set>
 #include <algorithm>
 #include <numeric>
 #include <string>
@@ -26,6 +27,7 @@
 
 namespace {
 int flag_verbose_mapper;
+amrex::Vector<int> rank_node_ids; // node ID of each rank in the world communicator
 }
 
 namespace amrex {
@@ -38,6 +40,7 @@ namespace amrex {
     int    sfc_threshold;
     Real   max_efficiency;
     int    node_size;
+    Real   graph_imbalance;
 
 // We default to SFC.
 DistributionMapping::Strategy DistributionMapping::m_Strategy = DistributionMapping::SFC;
@@ -75,6 +78,12 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case NODESFC:
+        m_BuildMap = &DistributionMapping::NodeSFCProcessorMap;
+        break;
+    case GRAPH:
+        m_BuildMap = &DistributionMapping::GraphProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -115,6 +124,7 @@ DistributionMapping::Initialize ()
     sfc_threshold    = 0;
     max_efficiency   = 0.9;
     node_size        = 0;
+    graph_imbalance  = 0.05;
     flag_verbose_mapper = 0;
 
     ParmParse pp("DistributionMapping");
@@ -124,6 +134,7 @@ DistributionMapping::Initialize ()
     pp.query("efficiency",          max_efficiency);
     pp.query("sfc_threshold",       sfc_threshold);
     pp.query("node_size",           node_size);
+    pp.query("graph_imbalance",     graph_imbalance);
     pp.query("verbose_mapper",      flag_verbose_mapper);
 
     std::string theStrategy;
@@ -146,6 +157,14 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "NODESFC")
+        {
+            strategy(NODESFC);
+        }
+        else if (theStrategy == "GRAPH")
+        {
+            strategy(GRAPH);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -158,6 +177,47 @@ DistributionMapping::Initialize ()
         strategy(m_Strategy);  // default
     }
 
+    //
+    // Find out which ranks share a compute node.  Node IDs are the lowest
+    // world rank on each node.
+    //
+    const int nprocs_all = ParallelDescriptor::NProcs();
+    rank_node_ids.resize(nprocs_all);
+    if (node_size > 0)
+    {
+        for (int i = 0; i < nprocs_all; ++i) {
+            rank_node_ids[i] = (i/node_size)*node_size;
+        }
+    }
+    else
+    {
+#if defined(BL_USE_MPI3)
+        MPI_Comm node_comm;
+        MPI_Comm_split_type(ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+                            0, MPI_INFO_NULL, &node_comm);
+        int node_id = ParallelDescriptor::MyProc();
+        MPI_Bcast(&node_id, 1, MPI_INT, 0, node_comm);
+        MPI_Comm_free(&node_comm);
+        ParallelAllGather::AllGather(node_id, rank_node_ids.data(), ParallelDescriptor::Communicator());
+#elif defined(BL_USE_MPI)
+        char name[MPI_MAX_PROCESSOR_NAME] = {0};
+        int len;
+        MPI_Get_processor_name(name, &len);
+        Vector<char> all_names(nprocs_all*MPI_MAX_PROCESSOR_NAME);
+        MPI_Allgather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                      all_names.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                      ParallelDescriptor::Communicator());
+        std::map<std::string,int> first_rank;
+        for (int i = 0; i < nprocs_all; ++i) {
+            std::string nm(&all_names[i*MPI_MAX_PROCESSOR_NAME]);
+            auto r = first_rank.insert(std::make_pair(nm,i));
+            rank_node_ids[i] = r.first->second;
+        }
+#else
+        rank_node_ids[0] = 0;
+#endif
+    }
+
     amrex::ExecOnFinalize(DistributionMapping::Finalize);
 
     initialized = true;
@@ -168,6 +228,8 @@ DistributionMapping::Finalize ()
 {
     initialized = false;
 
+    rank_node_ids.clear();
+
     m_Strategy = SFC;
 
     DistributionMapping::m_BuildMap = 0;
@@ -694,6 +756,336 @@ top: ;
     }
 }
 
+namespace
+{
+    //! Weighted graph in compressed sparse row format.
+    struct WeightedGraph
+    {
+        std::vector<long> vwgt;   //!< vertex weights
+        std::vector<int>  xadj;   //!< adjacency of vertex v is [xadj[v],xadj[v+1])
+        std::vector<int>  adjncy;
+        std::vector<long> adjwgt; //!< edge weights
+        int nvtxs () const { return vwgt.size(); }
+    };
+}
+
+//
+// Vertices are boxes and edge weights are the number of cells the two boxes
+// would exchange in a FillBoundary with one ghost cell.
+//
+static
+WeightedGraph
+box_graph (const BoxArray& ba, const std::vector<long>& wgts)
+{
+    BL_PROFILE("box_graph()");
+
+    const int N = ba.size();
+
+    std::vector<std::vector<std::pair<int,long> > > nbrs(N);
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i)
+    {
+        ba.intersections(amrex::grow(ba[i],1), isects);
+        for (auto const& is : isects)
+        {
+            const int j = is.first;
+            if (j != i) {
+                const long vol = is.second.numPts();
+                nbrs[i].push_back(std::make_pair(j,vol));
+                nbrs[j].push_back(std::make_pair(i,vol));
+            }
+        }
+    }
+
+    WeightedGraph g;
+    g.vwgt = wgts;
+    g.xadj.reserve(N+1);
+    g.xadj.push_back(0);
+    for (int i = 0; i < N; ++i)
+    {
+        auto& nb = nbrs[i];
+        std::sort(nb.begin(), nb.end());
+        for (int k = 0, M = nb.size(); k < M; )
+        {
+            const int j = nb[k].first;
+            long w = 0;
+            for ( ; k < M && nb[k].first == j; ++k) {
+                w += nb[k].second;
+            }
+            g.adjncy.push_back(j);
+            g.adjwgt.push_back(w);
+        }
+        g.xadj.push_back(g.adjncy.size());
+        std::vector<std::pair<int,long> >().swap(nb);
+    }
+    return g;
+}
+
+//
+// Coarsen by heavy edge matching.  cmap maps fine vertices to coarse vertices.
+//
+static
+WeightedGraph
+coarsen_graph (const WeightedGraph& g, long maxvwgt, std::vector<int>& cmap)
+{
+    const int n = g.nvtxs();
+
+    // Visit light vertices first so that the coarse vertex weights stay even.
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&] (int a, int b) { return g.vwgt[a] < g.vwgt[b]; });
+
+    std::vector<int> match(n, -1);
+    for (int v : order)
+    {
+        if (match[v] >= 0) continue;
+        int  best  = v;
+        long bestw = -1;
+        for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+        {
+            const int u = g.adjncy[e];
+            if (match[u] < 0 && g.adjwgt[e] > bestw && g.vwgt[u]+g.vwgt[v] <= maxvwgt)
+            {
+                best  = u;
+                bestw = g.adjwgt[e];
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+    }
+
+    cmap.assign(n, -1);
+    int nc = 0;
+    for (int v = 0; v < n; ++v)
+    {
+        if (cmap[v] < 0) {
+            cmap[v] = nc;
+            cmap[match[v]] = nc;
+            ++nc;
+        }
+    }
+
+    WeightedGraph cg;
+    cg.vwgt.assign(nc, 0);
+    cg.xadj.reserve(nc+1);
+    cg.xadj.push_back(0);
+
+    std::vector<int> members(n);
+    {
+        std::vector<int> cnt(nc+1, 0);
+        for (int v = 0; v < n; ++v) ++cnt[cmap[v]+1];
+        std::partial_sum(cnt.begin(), cnt.end(), cnt.begin());
+        for (int v = 0; v < n; ++v) members[cnt[cmap[v]]++] = v;
+    }
+
+    std::vector<int> where(nc, -1); // position of a coarse neighbor in cg.adjncy
+    int ifine = 0;
+    for (int c = 0; c < nc; ++c)
+    {
+        const int begin = cg.adjncy.size();
+        for ( ; ifine < n && cmap[members[ifine]] == c; ++ifine)
+        {
+            const int v = members[ifine];
+            cg.vwgt[c] += g.vwgt[v];
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+            {
+                const int cu = cmap[g.adjncy[e]];
+                if (cu == c) continue;
+                if (where[cu] < begin) {
+                    where[cu] = cg.adjncy.size();
+                    cg.adjncy.push_back(cu);
+                    cg.adjwgt.push_back(g.adjwgt[e]);
+                } else {
+                    cg.adjwgt[where[cu]] += g.adjwgt[e];
+                }
+            }
+        }
+        cg.xadj.push_back(cg.adjncy.size());
+    }
+
+    return cg;
+}
+
+//
+// Initial partition: order the vertices breadth first and cut the ordering
+// into nparts pieces of about equal weight.
+//
+static
+void
+initial_partition (const WeightedGraph& g, int nparts, std::vector<int>& part)
+{
+    const int n = g.nvtxs();
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    for (int s = 0; s < n; ++s)
+    {
+        if (visited[s]) continue;
+        visited[s] = 1;
+        std::size_t head = order.size();
+        order.push_back(s);
+        while (head < order.size())
+        {
+            const int v = order[head++];
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+            {
+                const int u = g.adjncy[e];
+                if (!visited[u]) {
+                    visited[u] = 1;
+                    order.push_back(u);
+                }
+            }
+        }
+    }
+
+    const long total = std::accumulate(g.vwgt.begin(), g.vwgt.end(), 0L);
+
+    part.resize(n);
+    long cum = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        const int v = order[k];
+        // Center of the vertex in the cumulative weight.
+        const double mid = cum + 0.5*g.vwgt[v];
+        int p = static_cast<int>(mid*nparts/std::max(total,1L));
+        // Leave enough vertices for the remaining parts.
+        p = std::max(p, nparts - (n-k));
+        part[v] = std::min(p, nparts-1);
+        cum += g.vwgt[v];
+    }
+}
+
+//
+// Greedy k-way refinement in the spirit of Kernighan-Lin/Fiduccia-Mattheyses.
+// Boundary vertices move to the neighboring part that reduces the cut most
+// without exceeding maxload.  Vertices in overloaded parts are moved even if
+// that increases the cut.
+//
+static
+void
+refine_partition (const WeightedGraph& g, int nparts, long maxload, std::vector<int>& part)
+{
+    const int n = g.nvtxs();
+
+    std::vector<long> pwgt(nparts, 0);
+    std::vector<int>  pcnt(nparts, 0);
+    for (int v = 0; v < n; ++v) {
+        pwgt[part[v]] += g.vwgt[v];
+        ++pcnt[part[v]];
+    }
+
+    std::vector<long> conn(nparts, 0);
+    std::vector<int> touched;
+
+    for (int pass = 0; pass < 16; ++pass)
+    {
+        int nmoves = 0;
+        for (int v = 0; v < n; ++v)
+        {
+            const int from = part[v];
+            if (pcnt[from] == 1) continue;
+
+            touched.clear();
+            for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e)
+            {
+                const int p = part[g.adjncy[e]];
+                if (conn[p] == 0) touched.push_back(p);
+                conn[p] += g.adjwgt[e];
+            }
+
+            const long vw = g.vwgt[v];
+            const bool overloaded = pwgt[from] > maxload;
+            int  best = -1;
+            long bestgain = std::numeric_limits<long>::lowest();
+            for (int p : touched)
+            {
+                if (p == from || pwgt[p] + vw > maxload) continue;
+                const long gain = conn[p] - conn[from];
+                const bool ok = overloaded || gain > 0
+                    || (gain == 0 && pwgt[p] + vw < pwgt[from]);
+                if (ok && (gain > bestgain || (gain == bestgain && pwgt[p] < pwgt[best])))
+                {
+                    best = p;
+                    bestgain = gain;
+                }
+            }
+
+            if (best < 0 && overloaded)
+            {
+                // No neighboring part can take it.  Move it to the lightest part.
+                best = std::min_element(pwgt.begin(), pwgt.end()) - pwgt.begin();
+                if (best == from || pwgt[best] + vw >= pwgt[from]) best = -1;
+            }
+
+            for (int p : touched) conn[p] = 0;
+
+            if (best >= 0)
+            {
+                part[v] = best;
+                pwgt[from] -= vw;
+                pwgt[best] += vw;
+                --pcnt[from];
+                ++pcnt[best];
+                ++nmoves;
+            }
+        }
+        if (nmoves == 0) break;
+    }
+}
+
+//
+// Multilevel partitioning of g into nparts parts.  Returns the cut weight.
+//
+static
+long
+partition_graph (const WeightedGraph& g, int nparts, long maxload, std::vector<int>& part)
+{
+    BL_PROFILE("partition_graph()");
+
+    const int coarsen_to = std::max(8*nparts, 64);
+
+    std::vector<WeightedGraph> graphs;
+    std::vector<std::vector<int> > cmaps;
+    const WeightedGraph* cur = &g;
+    while (cur->nvtxs() > coarsen_to)
+    {
+        std::vector<int> cmap;
+        WeightedGraph cg = coarsen_graph(*cur, maxload, cmap);
+        if (cg.nvtxs() > 0.95*cur->nvtxs()) break;
+        cmaps.push_back(std::move(cmap));
+        graphs.push_back(std::move(cg));
+        cur = &graphs.back();
+    }
+
+    initial_partition(*cur, nparts, part);
+
+    for (int lev = graphs.size()-1; lev >= 0; --lev)
+    {
+        const WeightedGraph& cg = graphs[lev];
+        const long maxvw = *std::max_element(cg.vwgt.begin(), cg.vwgt.end());
+        refine_partition(cg, nparts, std::max(maxload,maxvw), part);
+
+        const std::vector<int>& cmap = cmaps[lev];
+        std::vector<int> fpart(cmap.size());
+        for (int v = 0, N = cmap.size(); v < N; ++v) {
+            fpart[v] = part[cmap[v]];
+        }
+        part.swap(fpart);
+    }
+
+    refine_partition(g, nparts, maxload, part);
+
+    long cut = 0;
+    for (int v = 0, N = g.nvtxs(); v < N; ++v) {
+        for (int e = g.xadj[v]; e < g.xadj[v+1]; ++e) {
+            if (part[g.adjncy[e]] != part[v]) cut += g.adjwgt[e];
+        }
+    }
+    return cut/2;
+}
+
 void
 DistributionMapping::KnapSackDoIt (const std::vector<long>& wgts,
                                    int                    /*  nprocs */,
@@ -811,6 +1203,180 @@ DistributionMapping::KnapSackDoIt (const std::vector<long>& wgts,
 
 }
 
+void
+DistributionMapping::MigrationAwareProcessorMap (const BoxArray&            boxes,
+                                                 const std::vector<long>&   wgts,
+                                                 int                        nprocs,
+                                                 const BoxArray&            oldba,
+                                                 const DistributionMapping& olddm,
+                                                 Real                       migration_weight,
+                                                 int                        nmax)
+{
+    BL_PROFILE("DistributionMapping::MigrationAwareProcessorMap()");
+
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+    BL_ASSERT(oldba.size() == olddm.size());
+
+    const int N = boxes.size();
+
+    nmax = std::max(nmax, (N+nprocs-1)/nprocs);
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(N);
+
+    //
+    // The number of cells of each box already on each process.
+    //
+    std::vector< std::vector< std::pair<int,long> > > onproc(N);
+    std::vector<int> home(N, -1);
+    long ncells = 0;
+    {
+        std::vector< std::pair<int,Box> > isects;
+        for (int i = 0; i < N; ++i)
+        {
+            ncells += boxes[i].numPts();
+            oldba.intersections(boxes[i], isects);
+            std::vector< std::pair<int,long> >& op = onproc[i];
+            for (const auto& is : isects)
+            {
+                const int p = ParallelContext::global_to_local_rank(olddm[is.first]);
+                if (p < 0 || p >= nprocs) continue;
+                auto it = std::find_if(op.begin(), op.end(),
+                                       [=] (const std::pair<int,long>& x) { return x.first == p; });
+                if (it == op.end()) {
+                    op.push_back(std::make_pair(p, is.second.numPts()));
+                } else {
+                    it->second += is.second.numPts();
+                }
+            }
+            long most = 0;
+            for (const auto& x : op) {
+                if (x.second > most) {
+                    most = x.second;
+                    home[i] = x.first;
+                }
+            }
+        }
+    }
+
+    auto cells_on = [&] (int i, int p) -> long
+    {
+        for (const auto& x : onproc[i]) {
+            if (x.first == p) return x.second;
+        }
+        return 0L;
+    };
+
+    //
+    // Start at home, then add the boxes without old data, or whose home
+    // already has nmax boxes, heaviest first, to the least loaded process
+    // with fewer than nmax boxes.
+    //
+    std::vector<long> load(nprocs, 0L);
+    std::vector< std::vector<int> > owned(nprocs);
+    std::vector<int> pmap(N, -1);
+    std::vector<int> homeless;
+    long totwgt = 0;
+    for (int i = 0; i < N; ++i)
+    {
+        totwgt += wgts[i];
+        if (home[i] >= 0 && static_cast<int>(owned[home[i]].size()) < nmax) {
+            pmap[i] = home[i];
+            load[home[i]] += wgts[i];
+            owned[home[i]].push_back(i);
+        } else {
+            homeless.push_back(i);
+        }
+    }
+
+    std::set< std::pair<long,int> > byload;
+    for (int p = 0; p < nprocs; ++p) {
+        byload.insert(std::make_pair(load[p], p));
+    }
+
+    auto move_to = [&] (int i, int from, int to)
+    {
+        if (from >= 0) {
+            byload.erase(std::make_pair(load[from], from));
+            load[from] -= wgts[i];
+            byload.insert(std::make_pair(load[from], from));
+            std::vector<int>& v = owned[from];
+            v.erase(std::find(v.begin(), v.end(), i));
+        }
+        byload.erase(std::make_pair(load[to], to));
+        load[to] += wgts[i];
+        byload.insert(std::make_pair(load[to], to));
+        owned[to].push_back(i);
+        pmap[i] = to;
+    };
+
+    auto least_loaded = [&] () -> int
+    {
+        for (const auto& x : byload) {
+            if (static_cast<int>(owned[x.second].size()) < nmax) return x.second;
+        }
+        return -1;
+    };
+
+    std::stable_sort(homeless.begin(), homeless.end(),
+                     [&] (int a, int b) { return wgts[a] > wgts[b]; });
+    for (int i : homeless) {
+        move_to(i, -1, least_loaded());
+    }
+
+    //
+    // Each move reduces the sum of the squares of the loads, so this ends.
+    //
+    const Real avgwgt = std::max(Real(totwgt)/nprocs, Real(1.0));
+    long nmigrated = 0;
+    for (int i = 0; i < N; ++i) {
+        nmigrated += boxes[i].numPts() - cells_on(i, pmap[i]);
+    }
+
+    while (nprocs > 1)
+    {
+        const int  pmax = byload.rbegin()->second;
+        const int  pmin = least_loaded();
+        if (pmin < 0 || pmin == pmax) break;
+        const long lmax = load[pmax];
+        const long lmin = load[pmin];
+
+        int  best  = -1;
+        Real score = 0.0;
+        long dmig  = 0;
+        for (int i : owned[pmax])
+        {
+            const long w = wgts[i];
+            if (lmin + w >= lmax) continue;
+            const Real gain = Real(lmax - std::max(lmax-w, lmin+w)) / avgwgt;
+            const long dm = cells_on(i, pmax) - cells_on(i, pmin);
+            const Real s = gain - migration_weight * Real(dm) / Real(ncells);
+            if (s > score) {
+                best  = i;
+                score = s;
+                dmig  = dm;
+            }
+        }
+
+        if (best < 0) break;
+
+        move_to(best, pmax, pmin);
+        nmigrated += dmig;
+    }
+
+    for (int i = 0; i < N; ++i) {
+        m_ref->m_pmap[i] = ParallelContext::local_to_global_rank(pmap[i]);
+    }
+
+    if (verbose)
+    {
+        const long lmax = *std::max_element(load.begin(), load.end());
+        amrex::Print() << "MIGRATION AWARE efficiency: " << Real(totwgt)/(Real(nprocs)*lmax)
+                       << ", cells migrated: " << Real(nmigrated)/Real(ncells) << '\n';
+    }
+}
+
 void
 DistributionMapping::KnapSackProcessorMap (const std::vector<long>& wgts,
                                            int                      nprocs,
@@ -1322,6 +1888,178 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+const Vector<int>&
+DistributionMapping::NodeIDs ()
+{
+    return rank_node_ids;
+}
+
+void
+DistributionMapping::NodeSFCDoIt (const BoxArray&          boxes,
+                                  const std::vector<long>& wgts,
+                                  int                   /*   nprocs */)
+{
+    BL_PROFILE("DistributionMapping::NodeSFCDoIt()");
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    //
+    // Group the ranks of the current communicator by node.  nodes[n] holds the
+    // local ranks on node n, and nodes are ordered by their lowest rank.
+    //
+    std::vector<std::vector<int> > nodes;
+    {
+        std::map<int,int> node_index;
+        for (int r = 0; r < nprocs; ++r)
+        {
+            const int grank = ParallelContext::local_to_global_rank(r);
+            const int nid = rank_node_ids.empty() ? grank : rank_node_ids[grank];
+            auto it = node_index.insert(std::make_pair(nid, static_cast<int>(nodes.size())));
+            if (it.second) nodes.push_back(std::vector<int>());
+            nodes[it.first->second].push_back(r);
+        }
+    }
+
+    const int nnodes = nodes.size();
+
+    if (flag_verbose_mapper) {
+        Print() << "DM: NodeSFCDoIt: (nprocs, nnodes) = (" << nprocs << ", " << nnodes << ")\n";
+    }
+
+    std::vector<SFCToken> tokens;
+
+    const int N = boxes.size();
+
+    tokens.reserve(N);
+
+    int maxijk = 0;
+
+    for (int i = 0; i < N; ++i)
+    {
+	const Box& bx = boxes[i];
+        tokens.push_back(SFCToken(i,bx.smallEnd(),wgts[i]));
+
+        const SFCToken& token = tokens.back();
+
+        AMREX_D_TERM(maxijk = std::max(maxijk, token.m_idx[0]);,
+                     maxijk = std::max(maxijk, token.m_idx[1]);,
+                     maxijk = std::max(maxijk, token.m_idx[2]););
+    }
+    //
+    // Set SFCToken::MaxPower for BoxArray.
+    //
+    int m = 0;
+    for ( ; (1 << m) <= maxijk; ++m) {
+        ;  // do nothing
+    }
+    SFCToken::MaxPower = m;
+    //
+    // Put'm in Morton space filling curve order.
+    //
+    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+    //
+    // Split the curve into one chunk per rank, and give each node the
+    // consecutive chunks of as many ranks as it has.  Thus each node gets a
+    // contiguous piece of the curve proportional to its size.
+    //
+    Real volpercpu = 0;
+    for (const SFCToken& tok : tokens) {
+        volpercpu += tok.m_vol;
+    }
+    volpercpu /= nprocs;
+
+    std::vector< std::vector<int> > vec(nprocs);
+
+    Distribute(tokens,nprocs,volpercpu,vec);
+
+    tokens.clear();
+
+    long max_wgt = 0, sum_wgt = 0;
+
+    int ichunk = 0;
+    for (int n = 0; n < nnodes; ++n)
+    {
+        const std::vector<int>& ranks = nodes[n];
+        const int nranks = ranks.size();
+
+        std::vector<int> vi;
+        for (int c = 0; c < nranks; ++c, ++ichunk) {
+            vi.insert(vi.end(), vec[ichunk].begin(), vec[ichunk].end());
+        }
+
+        //
+        // Knapsack the boxes of this node among its ranks.
+        //
+        std::vector<long> local_wgts;
+        local_wgts.reserve(vi.size());
+        for (int ib : vi) {
+            local_wgts.push_back(wgts[ib]);
+        }
+
+        std::vector<std::vector<int> > kpres;
+        Real kpeff;
+        knapsack(local_wgts, nranks, kpres, kpeff, true, N);
+
+        // kpres has a size of nranks. kpres[] contains a vector of indices into vi.
+
+        for (int w = 0; w < nranks; ++w)
+        {
+            const int cpu = ParallelContext::local_to_global_rank(ranks[w]);
+            long wgt = 0;
+            for (int j : kpres[w]) {
+                m_ref->m_pmap[vi[j]] = cpu;
+                wgt += local_wgts[j];
+            }
+            max_wgt = std::max(max_wgt, wgt);
+            sum_wgt += wgt;
+        }
+    }
+
+    if (verbose)
+    {
+        amrex::Print() << "NODESFC efficiency: "
+                       << (max_wgt > 0 ? Real(sum_wgt)/(nprocs*Real(max_wgt)) : Real(1.0))
+                       << " (" << nnodes << " nodes)\n";
+    }
+}
+
+void
+DistributionMapping::NodeSFCProcessorMap (const BoxArray& boxes,
+                                          int             nprocs)
+{
+    std::vector<long> wgts;
+
+    wgts.reserve(boxes.size());
+
+    for (int i = 0, N = boxes.size(); i < N; ++i)
+    {
+        wgts.push_back(boxes[i].volume());
+    }
+
+    NodeSFCProcessorMap(boxes,wgts,nprocs);
+}
+
+void
+DistributionMapping::NodeSFCProcessorMap (const BoxArray&          boxes,
+                                          const std::vector<long>& wgts,
+                                          int                      nprocs)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() < sfc_threshold*nprocs)
+    {
+        KnapSackProcessorMap(wgts,nprocs);
+    }
+    else
+    {
+        NodeSFCDoIt(boxes,wgts,nprocs);
+    }
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost)
 {
@@ -1384,6 +2122,63 @@ DistributionMapping::makeKnapSack (const MultiFab& weight, int nmax)
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeKnapSack (const MultiFab& weight, const BoxArray& oldba,
+                                   const DistributionMapping& olddm, Real migration_weight,
+                                   int nmax)
+{
+    BL_PROFILE("makeKnapSack");
+
+    DistributionMapping r;
+
+    std::vector<long> cost(weight.size(), 1L);
+#ifdef BL_USE_MPI
+    {
+	Vector<Real> rcost(cost.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+	    int i = mfi.index();
+	    rcost[i] = weight[mfi].sum(mfi.validbox(),0);
+	}
+
+	ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
+
+	Real wmax = *std::max_element(rcost.begin(), rcost.end());
+	Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+
+	for (int i = 0; i < rcost.size(); ++i) {
+	    cost[i] = long(rcost[i]*scale) + 1L;
+	}
+    }
+#endif
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.MigrationAwareProcessorMap(weight.boxArray(), cost, nprocs, oldba, olddm, migration_weight, nmax);
+
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeMigrationAware (const BoxArray& ba, const BoxArray& oldba,
+                                         const DistributionMapping& olddm, Real migration_weight)
+{
+    DistributionMapping r;
+
+    std::vector<long> cost(ba.size());
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        cost[i] = ba[i].numPts();
+    }
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.MigrationAwareProcessorMap(ba, cost, nprocs, oldba, olddm, migration_weight);
+
+    return r;
+}
+
 DistributionMapping
 DistributionMapping::makeRoundRobin (const MultiFab& weight)
 {
@@ -1454,6 +2249,170 @@ DistributionMapping::makeSFC (const MultiFab& weight, bool sort)
     return r;
 }
 
+void
+DistributionMapping::GraphDoIt (const BoxArray&          boxes,
+                                const std::vector<long>& wgts,
+                                int                   /*   nprocs */,
+                                long*                    cut_volume)
+{
+    BL_PROFILE("DistributionMapping::GraphDoIt()");
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    const int N = boxes.size();
+
+    //
+    // Allow the larger of the requested imbalance and what knapsack achieves.
+    //
+    long maxload;
+    {
+        std::vector<std::vector<int> > kpres;
+        Real kpeff;
+        knapsack(wgts, nprocs, kpres, kpeff, true, N);
+        long kpmax = 0;
+        for (auto const& kp : kpres) {
+            long w = 0;
+            for (int i : kp) w += wgts[i];
+            kpmax = std::max(kpmax, w);
+        }
+        const Real avg = std::accumulate(wgts.begin(), wgts.end(), Real(0.0)) / nprocs;
+        maxload = std::max(kpmax, static_cast<long>(avg*(1.0+graph_imbalance)));
+    }
+
+    WeightedGraph g = box_graph(boxes, wgts);
+
+    std::vector<int> part;
+    const long cut = partition_graph(g, nprocs, maxload, part);
+
+    std::vector<long> pwgt(nprocs, 0);
+    for (int i = 0; i < N; ++i)
+    {
+        m_ref->m_pmap[i] = ParallelContext::local_to_global_rank(part[i]);
+        pwgt[part[i]] += wgts[i];
+    }
+
+    if (cut_volume) *cut_volume = cut;
+
+    if (verbose)
+    {
+        const long  max_wgt = *std::max_element(pwgt.begin(), pwgt.end());
+        const Real  sum_wgt = std::accumulate(pwgt.begin(), pwgt.end(), Real(0.0));
+        long total_volume = 0;
+        for (auto w : g.adjwgt) total_volume += w;
+        amrex::Print() << "GRAPH efficiency: " << sum_wgt/(nprocs*Real(max_wgt))
+                       << ", cut volume: " << cut << " of " << total_volume/2 << " cells\n";
+    }
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray& boxes,
+                                        int             nprocs)
+{
+    std::vector<long> wgts;
+
+    wgts.reserve(boxes.size());
+
+    for (int i = 0, N = boxes.size(); i < N; ++i)
+    {
+        wgts.push_back(boxes[i].volume());
+    }
+
+    GraphProcessorMap(boxes,wgts,nprocs);
+}
+
+void
+DistributionMapping::GraphProcessorMap (const BoxArray&          boxes,
+                                        const std::vector<long>& wgts,
+                                        int                      nprocs,
+                                        long*                    cut_volume)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (boxes.size() <= nprocs || boxes.size() < sfc_threshold*nprocs)
+    {
+        KnapSackProcessorMap(wgts,nprocs);
+        if (cut_volume) *cut_volume = -1;
+    }
+    else
+    {
+        GraphDoIt(boxes,wgts,nprocs,cut_volume);
+    }
+}
+
+DistributionMapping
+DistributionMapping::makeGraph (const MultiFab& weight, long* cut_volume)
+{
+    DistributionMapping r;
+
+    Vector<long> cost(weight.size());
+#ifdef BL_USE_MPI
+    {
+	Vector<Real> rcost(cost.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+	    int i = mfi.index();
+	    rcost[i] = weight[mfi].sum(mfi.validbox(),0);
+	}
+
+	ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
+
+	Real wmax = *std::max_element(rcost.begin(), rcost.end());
+        Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+
+	for (int i = 0; i < rcost.size(); ++i) {
+	    cost[i] = long(rcost[i]*scale) + 1L;
+	}
+    }
+#endif
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.GraphProcessorMap(weight.boxArray(), cost, nprocs, cut_volume);
+
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makeNodeSFC (const MultiFab& weight)
+{
+    DistributionMapping r;
+
+    Vector<long> cost(weight.size());
+#ifdef BL_USE_MPI
+    {
+	Vector<Real> rcost(cost.size(), 0.0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+	    int i = mfi.index();
+	    rcost[i] = weight[mfi].sum(mfi.validbox(),0);
+	}
+
+	ParallelAllReduce::Sum(&rcost[0], rcost.size(), ParallelContext::CommunicatorSub());
+
+	Real wmax = *std::max_element(rcost.begin(), rcost.end());
+        Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+
+	for (int i = 0; i < rcost.size(); ++i) {
+	    cost[i] = long(rcost[i]*scale) + 1L;
+	}
+    }
+#endif
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.NodeSFCProcessorMap(weight.boxArray(), cost, nprocs);
+
+    return r;
+}
+
 std::vector<std::vector<int> >
 DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol)
 {
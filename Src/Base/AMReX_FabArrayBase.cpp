@@ -23,6 +23,7 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::persistent_fb;
 
 #if defined(AMREX_USE_GPU) && defined(AMREX_USE_GPU_PRAGMA)
 
@@ -86,6 +87,7 @@ FabArrayBase::Initialize ()
     // Set default values here!!!
     //
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::persistent_fb     = false;
 
     ParmParse pp("fabarray");
 
@@ -107,6 +109,7 @@ FabArrayBase::Initialize ()
     }
 
     pp.query("maxcomp",             FabArrayBase::MaxComp);
+    pp.query("persistent_fillboundary", FabArrayBase::persistent_fb);
 
     if (MaxComp < 1) {
         MaxComp = 1;
@@ -988,6 +991,155 @@ FabArrayBase::FB::~FB ()
     delete m_RcvTags;
 }
 
+FabArrayBase::FB::PersistentComm*
+FabArrayBase::FB::getPersistentComm (int ncomp, std::size_t elemsize, int tag) const
+{
+#ifdef BL_USE_MPI
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+
+    for (auto const& p : m_pcomm)
+    {
+        if (p->m_ncomp == ncomp && p->m_elemsize == elemsize && p->m_comm == comm)
+        {
+            return (p->m_active) ? nullptr : p.get();
+        }
+    }
+
+    BL_PROFILE("FabArrayBase::FB::getPersistentComm()");
+
+    std::unique_ptr<PersistentComm> pc(new PersistentComm);
+    pc->m_ncomp    = ncomp;
+    pc->m_elemsize = elemsize;
+    pc->m_tag      = tag;
+    pc->m_comm     = comm;
+
+    const std::size_t bytes_per_pt = ncomp * elemsize;
+
+    std::size_t total_send_volume = 0;
+    for (auto const& kv : *m_SndTags)
+    {
+        std::size_t nbytes = 0;
+        for (auto const& cct : kv.second) {
+            nbytes += cct.sbox.numPts() * bytes_per_pt;
+        }
+        BL_ASSERT(nbytes < std::numeric_limits<int>::max());
+        total_send_volume += nbytes;
+        pc->m_send_size.push_back(static_cast<int>(nbytes));
+    }
+
+    std::size_t total_recv_volume = 0;
+    for (auto const& kv : *m_RcvTags)
+    {
+        std::size_t nbytes = 0;
+        for (auto const& cct : kv.second) {
+            nbytes += cct.dbox.numPts() * bytes_per_pt;
+        }
+        BL_ASSERT(nbytes < std::numeric_limits<int>::max());
+        total_recv_volume += nbytes;
+        pc->m_recv_size.push_back(static_cast<int>(nbytes));
+        pc->m_recv_from.push_back(kv.first);
+    }
+
+    if (total_send_volume > 0) {
+        pc->m_the_send_data = static_cast<char*>(amrex::The_FA_Arena()->alloc(total_send_volume));
+    }
+    if (total_recv_volume > 0) {
+        pc->m_the_recv_data = static_cast<char*>(amrex::The_FA_Arena()->alloc(total_recv_volume));
+    }
+
+    //
+    // Receives come first in m_reqs so that they are started first.
+    //
+    char* p = pc->m_the_recv_data;
+    for (int k = 0, N = pc->m_recv_size.size(); k < N; ++k)
+    {
+        const int n = pc->m_recv_size[k];
+        pc->m_recv_data.push_back(n > 0 ? p : nullptr);
+        if (n > 0) {
+            MPI_Request req;
+            BL_MPI_REQUIRE( MPI_Recv_init(p, n, MPI_CHAR,
+                                          ParallelContext::global_to_local_rank(pc->m_recv_from[k]),
+                                          tag, comm, &req) );
+            pc->m_reqs.push_back(req);
+            p += n;
+        }
+    }
+    pc->m_nrecv_reqs = pc->m_reqs.size();
+
+    p = pc->m_the_send_data;
+    int j = 0;
+    for (auto const& kv : *m_SndTags)
+    {
+        const int n = pc->m_send_size[j++];
+        pc->m_send_data.push_back(n > 0 ? p : nullptr);
+        if (n > 0) {
+            MPI_Request req;
+            BL_MPI_REQUIRE( MPI_Send_init(p, n, MPI_CHAR,
+                                          ParallelContext::global_to_local_rank(kv.first),
+                                          tag, comm, &req) );
+            pc->m_reqs.push_back(req);
+            p += n;
+        }
+    }
+
+    pc->m_stats.resize(pc->m_reqs.size());
+
+    m_pcomm.push_back(std::move(pc));
+    return m_pcomm.back().get();
+#else
+    amrex::ignore_unused(ncomp);
+    amrex::ignore_unused(elemsize);
+    amrex::ignore_unused(tag);
+    return nullptr;
+#endif
+}
+
+FabArrayBase::FB::PersistentComm::~PersistentComm ()
+{
+#ifdef BL_USE_MPI
+    if (m_active) wait();
+    for (auto& req : m_reqs) {
+        MPI_Request_free(&req);
+    }
+#endif
+    if (m_the_send_data) amrex::The_FA_Arena()->free(m_the_send_data);
+    if (m_the_recv_data) amrex::The_FA_Arena()->free(m_the_recv_data);
+}
+
+void
+FabArrayBase::FB::PersistentComm::start ()
+{
+    BL_ASSERT(!m_active);
+    m_active = true;
+#ifdef BL_USE_MPI
+    if (!m_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Startall(m_reqs.size(), m_reqs.data()) );
+    }
+#endif
+}
+
+void
+FabArrayBase::FB::PersistentComm::test ()
+{
+#if defined(BL_USE_MPI) && !defined(AMREX_DEBUG)
+    if (m_active && m_nrecv_reqs > 0) {
+        int flag;
+        MPI_Testall(m_nrecv_reqs, m_reqs.data(), &flag, m_stats.data());
+    }
+#endif
+}
+
+void
+FabArrayBase::FB::PersistentComm::wait ()
+{
+#ifdef BL_USE_MPI
+    if (!m_reqs.empty()) {
+        BL_MPI_REQUIRE( MPI_Waitall(m_reqs.size(), m_reqs.data(), m_stats.data()) );
+    }
+#endif
+    m_active = false;
+}
+
 void
 FabArrayBase::flushFB (bool no_assertion) const
 {
@@ -0,0 +1,204 @@
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <AMReX_FabCompress.H>
+#include <AMReX_BLassert.H>
+#include <AMReX.H>
+
+namespace amrex {
+namespace FabCompress {
+
+namespace {
+
+enum Method : char { Raw = 0, DeltaShuffleRLE = 1 };
+
+//
+// Token bytes of the run-length encoding.  A clear high bit starts a run
+// of (t+1) literal bytes.  A set high bit is a run of (t&0x7f)+1 zero
+// bytes; if t&0x7f is 0x7f the run continues by a varint-coded count.
+//
+constexpr unsigned char ZeroRun = 0x80;
+constexpr int MaxToken = 0x7f;
+
+template <typename U>
+void
+shuffle_deltas (const char* src, long nwords, unsigned char* planes)
+{
+    constexpr int nb = sizeof(U);
+    U prev = 0;
+    for (long i = 0; i < nwords; ++i) {
+        U u;
+        std::memcpy(&u, src + i*nb, nb);
+        const U d = u - prev;
+        prev = u;
+        // ---- zigzag so that small negative residuals have high zero bytes
+        const U z = (d << 1) ^ (U(0) - (d >> (8*nb-1)));
+        for (int b = 0; b < nb; ++b) {
+            planes[b*nwords + i] = static_cast<unsigned char>(z >> (8*b));
+        }
+    }
+}
+
+template <typename U>
+void
+unshuffle_deltas (const unsigned char* planes, long nwords, char* dst)
+{
+    constexpr int nb = sizeof(U);
+    U prev = 0;
+    for (long i = 0; i < nwords; ++i) {
+        U z = 0;
+        for (int b = 0; b < nb; ++b) {
+            z |= static_cast<U>(planes[b*nwords + i]) << (8*b);
+        }
+        const U d = (z >> 1) ^ (U(0) - (z & 1));
+        prev += d;
+        std::memcpy(dst + i*nb, &prev, nb);
+    }
+}
+
+long
+rle_encode (const unsigned char* src, long n, unsigned char* dst)
+{
+    long out = 0;
+    long i = 0;
+    while (i < n)
+    {
+        long j = i;
+        while (j < n && src[j] == 0) ++j;
+        if (j-i >= 2 || (j > i && j == n))
+        {
+            long len = j-i-1;
+            if (len < MaxToken) {
+                dst[out++] = ZeroRun | static_cast<unsigned char>(len);
+            } else {
+                dst[out++] = ZeroRun | MaxToken;
+                len -= MaxToken;
+                while (len >= 0x80) {
+                    dst[out++] = static_cast<unsigned char>(len | 0x80);
+                    len >>= 7;
+                }
+                dst[out++] = static_cast<unsigned char>(len);
+            }
+            i = j;
+        }
+        else
+        {
+            // ---- literals up to the next pair of zeros
+            const long start = i;
+            ++i;
+            while (i < n && i-start <= MaxToken &&
+                   ! (src[i] == 0 && i+1 < n && src[i+1] == 0)) {
+                ++i;
+            }
+            dst[out++] = static_cast<unsigned char>(i-start-1);
+            std::memcpy(dst+out, src+start, i-start);
+            out += i-start;
+        }
+    }
+    return out;
+}
+
+void
+rle_decode (const unsigned char* src, long nsrc, unsigned char* dst, long n)
+{
+    long in = 0, out = 0;
+    while (in < nsrc)
+    {
+        const unsigned char t = src[in++];
+        if (t & ZeroRun) {
+            long len = t & MaxToken;
+            if (len == MaxToken) {
+                long extra = 0;
+                int shift = 0;
+                unsigned char c;
+                do {
+                    c = src[in++];
+                    extra |= static_cast<long>(c & 0x7f) << shift;
+                    shift += 7;
+                } while (c & 0x80);
+                len += extra;
+            }
+            ++len;
+            if (out+len > n) amrex::Abort("FabCompress::Decompress: corrupt data");
+            std::memset(dst+out, 0, len);
+            out += len;
+        } else {
+            const long len = t + 1;
+            if (out+len > n || in+len > nsrc) amrex::Abort("FabCompress::Decompress: corrupt data");
+            std::memcpy(dst+out, src+in, len);
+            in += len;
+            out += len;
+        }
+    }
+    if (out != n) amrex::Abort("FabCompress::Decompress: corrupt data");
+}
+
+}
+
+long
+CompressBound (long nbytes)
+{
+    // ---- the method byte plus one token per MaxToken+1 literals
+    return 1 + nbytes + nbytes/(MaxToken+1) + 1;
+}
+
+long
+Compress (const char* src, long nwords, int wordsize, char* dst)
+{
+    const long nbytes = nwords * wordsize;
+
+    if (nbytes > 0 && (wordsize == 4 || wordsize == 8))
+    {
+        std::vector<unsigned char> planes(nbytes);
+        if (wordsize == 8) {
+            shuffle_deltas<std::uint64_t>(src, nwords, planes.data());
+        } else {
+            shuffle_deltas<std::uint32_t>(src, nwords, planes.data());
+        }
+        unsigned char* udst = reinterpret_cast<unsigned char*>(dst);
+        const long n = rle_encode(planes.data(), nbytes, udst+1);
+        BL_ASSERT(1+n <= CompressBound(nbytes));
+        if (n < nbytes) {
+            dst[0] = DeltaShuffleRLE;
+            return 1+n;
+        }
+    }
+
+    dst[0] = Raw;
+    std::memcpy(dst+1, src, nbytes);
+    return 1+nbytes;
+}
+
+void
+Decompress (const char* src, long nsrc, char* dst, long nwords, int wordsize)
+{
+    const long nbytes = nwords * wordsize;
+
+    if (nsrc < 1) amrex::Abort("FabCompress::Decompress: empty stream");
+
+    if (src[0] == Raw)
+    {
+        if (nsrc-1 != nbytes) amrex::Abort("FabCompress::Decompress: wrong size");
+        std::memcpy(dst, src+1, nbytes);
+    }
+    else if (src[0] == DeltaShuffleRLE && (wordsize == 4 || wordsize == 8))
+    {
+        std::vector<unsigned char> planes(nbytes);
+        rle_decode(reinterpret_cast<const unsigned char*>(src+1), nsrc-1,
+                   planes.data(), nbytes);
+        if (wordsize == 8) {
+            unshuffle_deltas<std::uint64_t>(planes.data(), nwords, dst);
+        } else {
+            unshuffle_deltas<std::uint32_t>(planes.data(), nwords, dst);
+        }
+    }
+    else
+    {
+        amrex::Abort("FabCompress::Decompress: unknown method");
+    }
+}
+
+}
+}
@@ -0,0 +1,417 @@
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <AMReX_MultiFabReducer.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_BLProfiler.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace amrex {
+
+namespace {
+
+#ifdef BL_USE_MPI
+//
+// The sums and maxima are packed in one element of a contiguous datatype
+// whose first entry is the number of sums, so a single user-defined
+// operation can add the first part and take the maximum of the rest.
+// Minima are stored negated.
+//
+void
+fused_reduce (void* invec, void* inoutvec, int* len, MPI_Datatype* dtype)
+{
+    int nbytes;
+    MPI_Type_size(*dtype, &nbytes);
+    const int n = nbytes / sizeof(Real);
+    const Real* in = static_cast<const Real*>(invec);
+    Real* io = static_cast<Real*>(inoutvec);
+    for (int e = 0; e < *len; ++e, in += n, io += n)
+    {
+        const int nsum = static_cast<int>(in[0]);
+        for (int i = 1; i <= nsum; ++i) {
+            io[i] += in[i];
+        }
+        for (int i = nsum+1; i < n; ++i) {
+            io[i] = std::max(io[i], in[i]);
+        }
+    }
+}
+
+MPI_Op fused_op = MPI_OP_NULL;
+
+void
+free_fused_op ()
+{
+    if (fused_op != MPI_OP_NULL) {
+        MPI_Op_free(&fused_op);
+        fused_op = MPI_OP_NULL;
+    }
+}
+
+MPI_Op
+get_fused_op ()
+{
+    if (fused_op == MPI_OP_NULL) {
+        MPI_Op_create(fused_reduce, 1, &fused_op);
+        amrex::ExecOnFinalize(free_fused_op);
+    }
+    return fused_op;
+}
+#endif
+
+template <class F>
+Real
+box_sum (const Box& bx, const Array4<int const>* m, F&& f)
+{
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    Real r = 0.0;
+    for         (int k = lo.z; k <= hi.z; ++k) {
+        for     (int j = lo.y; j <= hi.y; ++j) {
+            if (m) {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    if ((*m)(i,j,k)) r += f(i,j,k);
+                }
+            } else {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    r += f(i,j,k);
+                }
+            }
+        }
+    }
+    return r;
+}
+
+template <class F>
+Real
+box_max (const Box& bx, const Array4<int const>* m, Real r, F&& f)
+{
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    for         (int k = lo.z; k <= hi.z; ++k) {
+        for     (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                if (!m || (*m)(i,j,k)) r = std::max(r, f(i,j,k));
+            }
+        }
+    }
+    return r;
+}
+
+}
+
+int
+MultiFabReducer::add (Kind kind, const MultiFab& x, int xcomp, const MultiFab* y, int ycomp,
+                      int nghost, const iMultiFab* mask)
+{
+    BL_ASSERT(xcomp >= 0 && xcomp < x.nComp());
+    BL_ASSERT(nghost >= 0 && nghost <= x.nGrow());
+    BL_ASSERT(!y    || (ycomp >= 0 && ycomp < y->nComp() && nghost <= y->nGrow()));
+    BL_ASSERT(!mask || nghost <= mask->nGrow());
+
+    if (!m_ops.empty())
+    {
+        const MultiFab& x0 = *m_ops[0].x;
+        AMREX_ALWAYS_ASSERT(x.boxArray() == x0.boxArray() &&
+                            x.DistributionMap() == x0.DistributionMap());
+        AMREX_ALWAYS_ASSERT(!y || (y->boxArray() == x0.boxArray() &&
+                                   y->DistributionMap() == x0.DistributionMap()));
+    }
+    AMREX_ALWAYS_ASSERT(!mask || (mask->boxArray() == x.boxArray() &&
+                                  mask->DistributionMap() == x.DistributionMap()));
+
+    const bool is_sum = kind < Max;
+    int slot = 0;
+    for (const auto& op : m_ops) {
+        if ((op.kind < Max) == is_sum) ++slot;
+    }
+    if (is_sum) ++m_nsum;
+
+    m_ops.push_back(Op{kind, &x, y, mask, xcomp, ycomp, nghost, slot});
+    return m_ops.size()-1;
+}
+
+int
+MultiFabReducer::addSum (const MultiFab& mf, int comp, int nghost, const iMultiFab* mask)
+{
+    return add(Sum, mf, comp, nullptr, 0, nghost, mask);
+}
+
+int
+MultiFabReducer::addMin (const MultiFab& mf, int comp, int nghost, const iMultiFab* mask)
+{
+    return add(Min, mf, comp, nullptr, 0, nghost, mask);
+}
+
+int
+MultiFabReducer::addMax (const MultiFab& mf, int comp, int nghost, const iMultiFab* mask)
+{
+    return add(Max, mf, comp, nullptr, 0, nghost, mask);
+}
+
+int
+MultiFabReducer::addNorm0 (const MultiFab& mf, int comp, int nghost, const iMultiFab* mask)
+{
+    return add(Norm0, mf, comp, nullptr, 0, nghost, mask);
+}
+
+int
+MultiFabReducer::addNorm1 (const MultiFab& mf, int comp, int nghost, const iMultiFab* mask)
+{
+    return add(Norm1, mf, comp, nullptr, 0, nghost, mask);
+}
+
+int
+MultiFabReducer::addNorm2 (const MultiFab& mf, int comp, int nghost, const iMultiFab* mask)
+{
+    return add(Norm2, mf, comp, nullptr, 0, nghost, mask);
+}
+
+int
+MultiFabReducer::addDot (const MultiFab& x, int xcomp, const MultiFab& y, int ycomp,
+                         int nghost, const iMultiFab* mask)
+{
+    return add(Dot, x, xcomp, &y, ycomp, nghost, mask);
+}
+
+void
+MultiFabReducer::localReduce (Vector<Real>& buf) const
+{
+    BL_PROFILE("MultiFabReducer::localReduce()");
+
+    const int nsum = m_nsum;
+    const int n = 1 + m_ops.size();
+    buf.assign(n, 0.0);
+    for (int i = 1+nsum; i < n; ++i) {
+        buf[i] = std::numeric_limits<Real>::lowest();
+    }
+    for (const auto& op : m_ops) {
+        if (op.kind == Norm0) buf[1+nsum+op.slot] = 0.0;
+    }
+
+    if (m_ops.empty()) return;
+
+    Gpu::LaunchSafeGuard lsg(false);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<Real> priv(buf);
+
+        for (MFIter mfi(*m_ops[0].x, true); mfi.isValid(); ++mfi)
+        {
+            for (const auto& op : m_ops)
+            {
+                const Box& bx = mfi.growntilebox(op.nghost);
+                const auto x = op.x->array(mfi);
+                const int xc = op.xcomp;
+                const Array4<int const> ma = op.mask ? op.mask->array(mfi)
+                    : Array4<int const>(nullptr, Dim3{0,0,0}, Dim3{0,0,0});
+                const Array4<int const>* m = op.mask ? &ma : nullptr;
+
+                Real& s = (op.kind < Max) ? priv[1+op.slot] : priv[1+nsum+op.slot];
+
+                switch (op.kind)
+                {
+                case Sum:
+                    s += box_sum(bx, m, [&] (int i, int j, int k) { return x(i,j,k,xc); });
+                    break;
+                case Norm1:
+                    s += box_sum(bx, m, [&] (int i, int j, int k) { return std::abs(x(i,j,k,xc)); });
+                    break;
+                case Norm2:
+                    s += box_sum(bx, m, [&] (int i, int j, int k) { return x(i,j,k,xc)*x(i,j,k,xc); });
+                    break;
+                case Dot:
+                {
+                    const auto y = op.y->array(mfi);
+                    const int yc = op.ycomp;
+                    s += box_sum(bx, m, [&] (int i, int j, int k) { return x(i,j,k,xc)*y(i,j,k,yc); });
+                    break;
+                }
+                case Max:
+                    s = box_max(bx, m, s, [&] (int i, int j, int k) { return x(i,j,k,xc); });
+                    break;
+                case Min:
+                    s = box_max(bx, m, s, [&] (int i, int j, int k) { return -x(i,j,k,xc); });
+                    break;
+                case Norm0:
+                    s = box_max(bx, m, s, [&] (int i, int j, int k) { return std::abs(x(i,j,k,xc)); });
+                    break;
+                }
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp critical (multifabreducer)
+#endif
+        {
+            for (int i = 1; i <= nsum; ++i) {
+                buf[i] += priv[i];
+            }
+            for (int i = 1+nsum; i < n; ++i) {
+                buf[i] = std::max(buf[i], priv[i]);
+            }
+        }
+    }
+
+    buf[0] = nsum;
+}
+
+Vector<Real>
+MultiFabReducer::eval (bool local) const
+{
+    Handle h;
+    localReduce(h.m_buf);
+
+#ifdef BL_USE_MPI
+    if (!local && ParallelDescriptor::NProcs() > 1)
+    {
+        BL_PROFILE("MultiFabReducer::Allreduce");
+        MPI_Datatype t;
+        MPI_Type_contiguous(h.m_buf.size(), ParallelDescriptor::Mpi_typemap<Real>::type(), &t);
+        MPI_Type_commit(&t);
+        MPI_Allreduce(MPI_IN_PLACE, h.m_buf.data(), 1, t, get_fused_op(),
+                      ParallelContext::CommunicatorSub());
+        MPI_Type_free(&t);
+    }
+#endif
+
+    for (const auto& op : m_ops) {
+        h.m_kind.push_back(op.kind);
+        h.m_slot.push_back((op.kind < Max) ? 1+op.slot : 1+m_nsum+op.slot);
+    }
+    h.finish();
+    return std::move(h.m_result);
+}
+
+MultiFabReducer::Handle
+MultiFabReducer::evalAsync () const
+{
+    Handle h;
+    localReduce(h.m_buf);
+
+    for (const auto& op : m_ops) {
+        h.m_kind.push_back(op.kind);
+        h.m_slot.push_back((op.kind < Max) ? 1+op.slot : 1+m_nsum+op.slot);
+    }
+
+#ifdef BL_USE_MPI
+    if (ParallelDescriptor::NProcs() > 1)
+    {
+        BL_PROFILE("MultiFabReducer::Iallreduce");
+        MPI_Type_contiguous(h.m_buf.size(), ParallelDescriptor::Mpi_typemap<Real>::type(), &h.m_type);
+        MPI_Type_commit(&h.m_type);
+        MPI_Iallreduce(MPI_IN_PLACE, h.m_buf.data(), 1, h.m_type, get_fused_op(),
+                       ParallelContext::CommunicatorSub(), &h.m_req);
+        h.m_pending = true;
+        return h;
+    }
+#endif
+
+    h.finish();
+    return h;
+}
+
+MultiFabReducer::Handle::~Handle ()
+{
+    if (m_pending) finish();
+}
+
+MultiFabReducer::Handle::Handle (Handle&& rhs) noexcept
+    : m_buf(std::move(rhs.m_buf)),
+      m_result(std::move(rhs.m_result)),
+      m_kind(std::move(rhs.m_kind)),
+      m_slot(std::move(rhs.m_slot)),
+      m_pending(rhs.m_pending)
+#ifdef BL_USE_MPI
+    , m_req(rhs.m_req),
+      m_type(rhs.m_type)
+#endif
+{
+    rhs.m_pending = false;
+#ifdef BL_USE_MPI
+    rhs.m_req  = MPI_REQUEST_NULL;
+    rhs.m_type = MPI_DATATYPE_NULL;
+#endif
+}
+
+MultiFabReducer::Handle&
+MultiFabReducer::Handle::operator= (Handle&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        if (m_pending) finish();
+        m_buf     = std::move(rhs.m_buf);
+        m_result  = std::move(rhs.m_result);
+        m_kind    = std::move(rhs.m_kind);
+        m_slot    = std::move(rhs.m_slot);
+        m_pending = rhs.m_pending;
+        rhs.m_pending = false;
+#ifdef BL_USE_MPI
+        m_req  = rhs.m_req;
+        m_type = rhs.m_type;
+        rhs.m_req  = MPI_REQUEST_NULL;
+        rhs.m_type = MPI_DATATYPE_NULL;
+#endif
+    }
+    return *this;
+}
+
+bool
+MultiFabReducer::Handle::isReady ()
+{
+#ifdef BL_USE_MPI
+    if (m_pending)
+    {
+        int flag = 0;
+        MPI_Test(&m_req, &flag, MPI_STATUS_IGNORE);
+        if (!flag) return false;
+        finish();
+    }
+#endif
+    return true;
+}
+
+const Vector<Real>&
+MultiFabReducer::Handle::get ()
+{
+    if (m_pending) finish();
+    return m_result;
+}
+
+void
+MultiFabReducer::Handle::finish ()
+{
+#ifdef BL_USE_MPI
+    if (m_pending)
+    {
+        BL_PROFILE("MultiFabReducer::Wait");
+        MPI_Wait(&m_req, MPI_STATUS_IGNORE);
+        MPI_Type_free(&m_type);
+        m_pending = false;
+    }
+#endif
+
+    const int n = m_kind.size();
+    m_result.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        const Real v = m_buf[m_slot[i]];
+        switch (m_kind[i])
+        {
+        case Norm2: m_result[i] = std::sqrt(v); break;
+        case Min:   m_result[i] = -v;           break;
+        default:    m_result[i] = v;
+        }
+    }
+}
+
+}
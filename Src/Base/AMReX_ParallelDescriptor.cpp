@@ -289,6 +289,25 @@ ParallelDescriptor::Message::count () const
     return cnt;
 }
 
+void
+ParallelDescriptor::ReduceRequest::Wait ()
+{
+    if (m_req != MPI_REQUEST_NULL) {
+        BL_PROFILE_S("ParallelDescriptor::ReduceRequest::Wait()");
+        BL_MPI_REQUIRE( MPI_Wait(&m_req, MPI_STATUS_IGNORE) );
+    }
+}
+
+bool
+ParallelDescriptor::ReduceRequest::Test ()
+{
+    int flag = 1;
+    if (m_req != MPI_REQUEST_NULL) {
+        BL_MPI_REQUIRE( MPI_Test(&m_req, &flag, MPI_STATUS_IGNORE) );
+    }
+    return flag != 0;
+}
+
 void
 ParallelDescriptor::StartParallel (int*    argc,
                                    char*** argv,
@@ -927,6 +946,72 @@ ParallelDescriptor::ReduceLongAnd (Vector<std::reference_wrapper<long> >&& rvar,
     }
 }
 
+namespace {
+    template <typename T>
+    ParallelDescriptor::ReduceRequest
+    DoIAllReduce (T* r, MPI_Op op, int cnt)
+    {
+#ifdef BL_LAZY
+        Lazy::EvalReduction();
+#endif
+        BL_PROFILE_S("ParallelDescriptor::DoIAllReduce()");
+        BL_ASSERT(cnt > 0);
+        MPI_Request req;
+        BL_MPI_REQUIRE( MPI_Iallreduce(MPI_IN_PLACE, r, cnt,
+                                       ParallelDescriptor::Mpi_typemap<T>::type(), op,
+                                       ParallelDescriptor::Communicator(), &req) );
+        return ParallelDescriptor::ReduceRequest(req);
+    }
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceRealSum (Real& r)
+{
+    return DoIAllReduce(&r,MPI_SUM,1);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceRealSum (Real* r, int cnt)
+{
+    return DoIAllReduce(r,MPI_SUM,cnt);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceRealMax (Real& r)
+{
+    return DoIAllReduce(&r,MPI_MAX,1);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceRealMax (Real* r, int cnt)
+{
+    return DoIAllReduce(r,MPI_MAX,cnt);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceRealMin (Real& r)
+{
+    return DoIAllReduce(&r,MPI_MIN,1);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceRealMin (Real* r, int cnt)
+{
+    return DoIAllReduce(r,MPI_MIN,cnt);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceLongSum (long& r)
+{
+    return DoIAllReduce(&r,MPI_SUM,1);
+}
+
+ParallelDescriptor::ReduceRequest
+ParallelDescriptor::IReduceLongSum (long* r, int cnt)
+{
+    return DoIAllReduce(r,MPI_SUM,cnt);
+}
+
 void
 ParallelDescriptor::util::DoAllReduceReal (Real&  r,
                                            MPI_Op op)
@@ -1689,6 +1774,16 @@ ParallelDescriptor::Message::test ()
     return m_finished;
 }
 
+void
+ParallelDescriptor::ReduceRequest::Wait ()
+{}
+
+bool
+ParallelDescriptor::ReduceRequest::Test ()
+{
+    return true;
+}
+
 void ParallelDescriptor::EndParallel () 
 {
     ParallelContext::pop();
@@ -1768,6 +1863,15 @@ void ParallelDescriptor::ReduceLongSum (Vector<std::reference_wrapper<long> >&&
 void ParallelDescriptor::ReduceLongMax (Vector<std::reference_wrapper<long> >&& rvar, int cpu) {}
 void ParallelDescriptor::ReduceLongMin (Vector<std::reference_wrapper<long> >&& rvar, int cpu) {}
 
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceRealSum (Real&) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceRealSum (Real*,int) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceRealMax (Real&) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceRealMax (Real*,int) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceRealMin (Real&) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceRealMin (Real*,int) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceLongSum (long&) { return ReduceRequest(); }
+ParallelDescriptor::ReduceRequest ParallelDescriptor::IReduceLongSum (long*,int) { return ReduceRequest(); }
+
 void ParallelDescriptor::ReduceIntSum (int&) {}
 void ParallelDescriptor::ReduceIntMax (int&) {}
 void ParallelDescriptor::ReduceIntMin (int&) {}
@@ -115,6 +115,16 @@ PlotFileDataImpl::syncDistributionMap (int level, PlotFileDataImpl const& src)
     }
 }
 
+int
+PlotFileDataImpl::varIndex (std::string const& varname) const
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
+    }
+    return std::distance(std::begin(m_var_names), r);
+}
+
 MultiFab
 PlotFileDataImpl::get (int level)
 {
@@ -126,20 +136,52 @@ PlotFileDataImpl::get (int level)
 MultiFab
 PlotFileDataImpl::get (int level, std::string const& varname)
 {
+    const int icomp = varIndex(varname);
     MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
-    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
-    if (r == std::end(m_var_names)) {
-        amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
-    } else {
-        int icomp = std::distance(std::begin(m_var_names), r);
-        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            int gid = mfi.index();
-            FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy(*srcfab);
-        }
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        mf[mfi].copy(m_vismf[level]->mapFAB(mfi.index(), icomp));
     }
     return mf;
 }
 
+MultiFab
+PlotFileDataImpl::getView (int level)
+{
+    if (!m_vismf[level]->canMapFAB()) {
+        return get(level);
+    }
+    // The fabs alias the mapped files and are read as they are touched.
+    MultiFab mf(m_ba[level], m_dmap[level], m_ncomp, m_ngrow[level], MFInfo().SetAlloc(false));
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        mf.setFab(mfi, new FArrayBox(m_vismf[level]->mapFAB(mfi.index())));
+    }
+    return mf;
+}
+
+MultiFab
+PlotFileDataImpl::getView (int level, std::string const& varname)
+{
+    if (!m_vismf[level]->canMapFAB()) {
+        return get(level, varname);
+    }
+    const int icomp = varIndex(varname);
+    MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level], MFInfo().SetAlloc(false));
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        mf.setFab(mfi, new FArrayBox(m_vismf[level]->mapFAB(mfi.index(), icomp)));
+    }
+    return mf;
+}
+
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid)
+{
+    return m_vismf[level]->mapFAB(gid);
+}
+
+FArrayBox
+PlotFileDataImpl::getFab (int level, int gid, std::string const& varname)
+{
+    return m_vismf[level]->mapFAB(gid, varIndex(varname));
+}
+
 }
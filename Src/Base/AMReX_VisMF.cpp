@@ -6,6 +6,16 @@
 #include <vector>
 #include <deque>
 #include <cerrno>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <AMReX_ccse-mpi.H>
 #include <AMReX_Utility.H>
@@ -13,6 +23,8 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_NFiles.H>
 #include <AMReX_FPC.H>
+#include <AMReX_FabCompress.H>
+#include <AMReX_ParallelReduce.H>
 
 namespace amrex {
 
@@ -33,6 +45,9 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+bool VisMF::asyncWrite(false);
+int  VisMF::asyncMaxBuffers(2);
+bool VisMF::useMMap(false);
 
 long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -46,6 +61,159 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // The helper thread of VisMF::AsyncWrite.  Jobs run in order, do file
+    // I/O only (no MPI) and return an error message or an empty string.
+    //
+    class AsyncWriter
+    {
+    public:
+        typedef std::function<std::string()> Job;
+
+        ~AsyncWriter () { finalize(); }
+
+        //! Queue a job, first waiting until fewer than max_jobs are in flight.
+        void push (Job&& job, int max_jobs)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if ( ! m_thread.joinable()) {
+                m_thread = std::thread(&AsyncWriter::run, this);
+            }
+            m_done_cv.wait(lock, [&] { return m_nactive < max_jobs; });
+            m_jobs.push_back(std::move(job));
+            ++m_nactive;
+            m_cv.notify_one();
+        }
+
+        //! Wait until all jobs have finished.  Returns the first error.
+        std::string wait ()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done_cv.wait(lock, [&] { return m_nactive == 0; });
+            std::string err;
+            std::swap(err, m_error);
+            return err;
+        }
+
+        bool pending ()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_nactive > 0;
+        }
+
+        //! Finish all jobs and stop the thread.
+        std::string finalize ()
+        {
+            std::string err = wait();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+                m_cv.notify_one();
+            }
+            if (m_thread.joinable()) {
+                m_thread.join();
+            }
+            m_stop = false;
+            return err;
+        }
+
+    private:
+        void run ()
+        {
+            while (true)
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [&] { return m_stop || ! m_jobs.empty(); });
+                    if (m_jobs.empty()) {
+                        return;
+                    }
+                    job = std::move(m_jobs.front());
+                    m_jobs.pop_front();
+                }
+                std::string err = job();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_error.empty()) {
+                        m_error = err;
+                    }
+                    --m_nactive;
+                }
+                m_done_cv.notify_all();
+            }
+        }
+
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::condition_variable m_done_cv;
+        std::deque<Job> m_jobs;
+        int m_nactive = 0;
+        bool m_stop = false;
+        std::string m_error;
+    };
+
+    AsyncWriter async_writer;
+
+    //
+    // Write nbytes at offset of an existing or new file without disturbing
+    // the rest of it, so that processes sharing a file can write concurrently.
+    //
+    std::string WriteAt (const std::string& fileName, long offset,
+                         const char* data, long nbytes)
+    {
+        int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) {
+            return "VisMF::AsyncWrite: unable to open " + fileName;
+        }
+        while (nbytes > 0) {
+            ssize_t n = ::pwrite(fd, data, nbytes, offset);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ::close(fd);
+                return "VisMF::AsyncWrite: write failed for " + fileName;
+            }
+            data   += n;
+            offset += n;
+            nbytes -= n;
+        }
+        if (::close(fd) != 0) {
+            return "VisMF::AsyncWrite: close failed for " + fileName;
+        }
+        return std::string();
+    }
+
+    //
+    // Read the compressed fab of idx at the current position of is and put
+    // nItems values, starting with item firstItem, into dst.
+    //
+    void ReadCompressedFab (std::istream& is, const VisMF::Header& hdr, int idx,
+                            Real* dst, long firstItem, long nItems)
+    {
+        Box fab_box(hdr.m_ba[idx]);
+        fab_box.grow(hdr.m_ngrow);
+        const long allItems(fab_box.numPts() * hdr.m_ncomp);
+        const int rdBytes(hdr.m_writtenRD.numBytes());
+        BL_ASSERT(firstItem + nItems <= allItems);
+
+        Vector<char> cData(hdr.m_csize[idx]);
+        is.read(cData.dataPtr(), cData.size());
+        if( ! is.good()) {
+          amrex::Abort("VisMF::readFAB: unable to read compressed fab");
+        }
+        Vector<char> rdData(allItems * rdBytes);
+        FabCompress::Decompress(cData.dataPtr(), cData.size(), rdData.dataPtr(),
+                                allItems, rdBytes);
+
+        const char *src = rdData.dataPtr() + firstItem * rdBytes;
+        if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
+          memcpy(dst, src, nItems * rdBytes);
+        } else {
+          RealDescriptor::convertToNativeFormat(dst, nItems, (void *) src, hdr.m_writtenRD);
+        }
+    }
 }
 
 void
@@ -82,6 +250,11 @@ VisMF::Initialize ()
     pp.query("usedynamicsetselection", useDynamicSetSelection);
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
+    pp.query("asyncwrite", asyncWrite);
+    pp.query("usemmap", useMMap);
+    int nbuffers(asyncMaxBuffers);
+    pp.query("asyncmaxbuffers", nbuffers);
+    SetAsyncMaxBuffers(nbuffers);
 
     initialized = true;
 }
@@ -89,6 +262,10 @@ VisMF::Initialize ()
 void
 VisMF::Finalize ()
 {
+    std::string err = async_writer.finalize();
+    if ( ! err.empty()) {
+        amrex::Abort(err);
+    }
     initialized = false;
 }
 
@@ -281,8 +458,17 @@ operator<< (std::ostream        &os,
 
     os << hd.m_fod      << '\n';
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      BL_ASSERT(hd.m_csize.size() == hd.m_fod.size());
+      os << hd.m_csize.size() << '\n';
+      for(int i(0); i < hd.m_csize.size(); ++i) {
+        os << hd.m_csize[i] << '\n';
+      }
+    }
+
     if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       os << hd.m_min      << '\n';
       os << hd.m_max      << '\n';
@@ -303,7 +489,8 @@ operator<< (std::ostream        &os,
 
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         os << FPC::NativeRealDescriptor() << '\n';
@@ -365,8 +552,19 @@ operator>> (std::istream  &is,
     is >> hd.m_fod;
     BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      long nsizes;
+      is >> nsizes;
+      hd.m_csize.resize(nsizes);
+      for(int i(0); i < hd.m_csize.size(); ++i) {
+        is >> hd.m_csize[i];
+      }
+      BL_ASSERT(hd.m_csize.size() == hd.m_fod.size());
+    }
+
     if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_min;
       is >> hd.m_max;
@@ -393,7 +591,8 @@ operator>> (std::istream  &is,
     }
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_writtenRD;
     }
@@ -969,6 +1168,8 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     NFilesIter nfi(nOutFiles, filePrefix, groupSets, setBuf);
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
+    bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    Vector<long> compressedFabs;  // ---- [fab index, file number, offset, bytes]
 
       if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
@@ -976,6 +1177,35 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         nfi.SetDynamic();
       }
       for( ; nfi.ReadyToWrite(); ++nfi) {
+          if(compressed) {
+            // ---- each fab is compressed separately so it can be read on its own
+            const int whichRDBytes(whichRD->numBytes());
+            Vector<char> rdData, cData;
+            for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+              const FArrayBox &fab = mf[mfi];
+              const long writeDataItems(fab.box().numPts() * mf.nComp());
+              const char *fabData = reinterpret_cast<const char *>(fab.dataPtr());
+              if(doConvert) {
+                rdData.resize(writeDataItems * whichRDBytes);
+                RealDescriptor::convertFromNativeFormat(static_cast<void *> (rdData.dataPtr()),
+                                                        writeDataItems,
+                                                        fab.dataPtr(), *whichRD);
+                fabData = rdData.dataPtr();
+              }
+              cData.resize(FabCompress::CompressBound(writeDataItems * whichRDBytes));
+              const long cBytes(FabCompress::Compress(fabData, writeDataItems, whichRDBytes,
+                                                      cData.dataPtr()));
+              compressedFabs.push_back(mfi.index());
+              compressedFabs.push_back(nfi.FileNumber());
+              compressedFabs.push_back(VisMF::FileOffset(nfi.Stream()));
+              compressedFabs.push_back(cBytes);
+              nfi.Stream().write(cData.dataPtr(), cBytes);
+              bytesWritten += cBytes;
+            }
+            nfi.Stream().flush();
+            continue;
+          }
+
 	  // ---- find the total number of bytes including fab headers if needed
           const FABio &fio = FArrayBox::getFABio();
           int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1063,12 +1293,17 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     }
 
     if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       currentVersion == VisMF::Header::Compressed_v1)
     {
       hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
-    VisMF::FindOffsets(mf, filePrefix, hdr, groupSets, currentVersion, nfi);
+    if(compressed) {
+      VisMF::GatherCompressedFabs(mf, compressedFabs, filePrefix, hdr, coordinatorProc);
+    } else {
+      VisMF::FindOffsets(mf, filePrefix, hdr, groupSets, currentVersion, nfi);
+    }
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
@@ -1078,6 +1313,236 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 }
 
 
+long
+VisMF::AsyncWrite (const FabArray<FArrayBox>& mf,
+                   const std::string& mf_name,
+                   VisMF::How         how)
+{
+    BL_PROFILE("VisMF::AsyncWrite(FabArray)");
+    BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
+    BL_ASSERT(currentVersion != VisMF::Header::Undefined_v1);
+
+    RealDescriptor *whichRD = nullptr;
+    if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
+      whichRD = FPC::NativeRealDescriptor().clone();
+    } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
+      whichRD = FPC::Native32RealDescriptor().clone();
+    } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
+      whichRD = FPC::Ieee32NormalRealDescriptor().clone();
+    } else {
+      Abort("VisMF::AsyncWrite unable to execute with the current fab.format setting.  Use NATIVE, NATIVE_32 or IEEE_32");
+    }
+    bool doConvert(*whichRD != FPC::NativeRealDescriptor());
+    const long whichRDBytes(whichRD->numBytes());
+
+    const int myProc(ParallelDescriptor::MyProc());
+    const int nProcs(ParallelDescriptor::NProcs());
+    const int coordinatorProc(ParallelDescriptor::IOProcessorNumber());
+    const bool oldHeader(currentVersion == VisMF::Header::Version_v1);
+    const FABio &fio = FArrayBox::getFABio();
+    const int nComps(mf.nComp());
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+    const int nFABs(mf.size());
+
+    const bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+
+    //
+    // Each process writes its fabs, in index order, to a contiguous range
+    // of its file; the processes sharing a file follow each other in rank
+    // order.  Uncompressed, the layout depends only on the BoxArray and
+    // DistributionMapping, so every process computes it without
+    // communication.  Compressed sizes are known only after the snapshot
+    // below and are exchanged then.
+    //
+    Vector<long> fabBytes(nFABs, 0L);
+    Vector<long> procBytes(nProcs, 0L);
+    for(int i(0); i < nFABs; ++i) {
+      if(compressed && pmap[i] != myProc) {
+        continue;
+      }
+      const Box &fbox = mf.fabbox(i);
+      fabBytes[i] = fbox.numPts() * nComps * whichRDBytes;
+      if(oldHeader) {
+        std::stringstream hss;
+        FArrayBox tempFab(fbox, nComps, false);  // ---- no alloc
+        fio.write_header(hss, tempFab, nComps);
+        fabBytes[i] += static_cast<std::streamoff>(hss.tellp());
+      }
+      if(compressed) {
+        fabBytes[i] = FabCompress::CompressBound(fabBytes[i]);
+      }
+      procBytes[pmap[i]] += fabBytes[i];
+    }
+
+    //
+    // Snapshot this process's fabs into a staging buffer.
+    //
+#ifdef AMREX_USE_GPU
+    Gpu::Device::synchronize();
+#endif
+    char *staging(nullptr);
+    if(procBytes[myProc] > 0) {
+      staging = static_cast<char *>(The_Pinned_Arena()->alloc(procBytes[myProc]));
+      Vector<char> rdData;
+      long writePosition(0);
+      for(int i(0); i < nFABs; ++i) {
+        if(pmap[i] != myProc) {
+          continue;
+        }
+        const FArrayBox &fab = mf[i];
+        const long writeDataItems(fab.box().numPts() * nComps);
+        char *afPtr = staging + writePosition;
+        if(compressed) {
+          const char *fabData = reinterpret_cast<const char *>(fab.dataPtr());
+          if(doConvert) {
+            rdData.resize(writeDataItems * whichRDBytes);
+            RealDescriptor::convertFromNativeFormat(static_cast<void *> (rdData.dataPtr()),
+                                                    writeDataItems,
+                                                    fab.dataPtr(), *whichRD);
+            fabData = rdData.dataPtr();
+          }
+          fabBytes[i] = FabCompress::Compress(fabData, writeDataItems, whichRDBytes, afPtr);
+          writePosition += fabBytes[i];
+          continue;
+        }
+        long hLength(0);
+        if(oldHeader) {
+          std::stringstream hss;
+          fio.write_header(hss, fab, nComps);
+          hLength = static_cast<std::streamoff>(hss.tellp());
+          memcpy(afPtr, hss.str().c_str(), hLength);  // ---- the fab header
+        }
+        if(doConvert) {
+          RealDescriptor::convertFromNativeFormat(static_cast<void *> (afPtr + hLength),
+                                                  writeDataItems,
+                                                  fab.dataPtr(), *whichRD);
+        } else {
+          memcpy(afPtr + hLength, fab.dataPtr(), writeDataItems * whichRDBytes);
+        }
+        writePosition += fabBytes[i];
+      }
+      BL_ASSERT(writePosition <= procBytes[myProc]);
+      procBytes[myProc] = writePosition;
+    }
+    delete whichRD;
+
+    if(compressed) {
+      long myCompressedBytes(procBytes[myProc]);
+      ParallelAllGather::AllGather(myCompressedBytes, procBytes.dataPtr(),
+                                   ParallelDescriptor::Communicator());
+    }
+
+    const int nFiles(NFilesIter::ActualNFiles(nOutFiles));
+    const std::string filePrefix(mf_name + FabFileSuffix);
+    Vector<long> procOffset(nProcs, 0L);
+    Vector<long> fileBytes(nFiles, 0L);
+    Vector<int>  fileFirstProc(nFiles, -1);
+    for(int p(0); p < nProcs; ++p) {
+      const int fn(NFilesIter::FileNumber(nFiles, p, groupSets));
+      procOffset[p] = fileBytes[fn];
+      fileBytes[fn] += procBytes[p];
+      if(fileFirstProc[fn] < 0) {
+        fileFirstProc[fn] = p;
+      }
+    }
+
+    const int myFileNumber(NFilesIter::FileNumber(nFiles, myProc, groupSets));
+    const std::string myFileName(NFilesIter::FileName(myFileNumber, filePrefix));
+    const long myBytes(procBytes[myProc]);
+
+    VisMF::Header hdr(mf, how, currentVersion, false);
+
+    if(compressed) {
+      Vector<long> localFabs;  // ---- [fab index, file number, offset, bytes]
+      long currentOffset(procOffset[myProc]);
+      for(int i(0); i < nFABs; ++i) {
+        if(pmap[i] == myProc) {
+          localFabs.push_back(i);
+          localFabs.push_back(myFileNumber);
+          localFabs.push_back(currentOffset);
+          localFabs.push_back(fabBytes[i]);
+          currentOffset += fabBytes[i];
+        }
+      }
+      VisMF::GatherCompressedFabs(mf, localFabs, filePrefix, hdr, coordinatorProc);
+    } else if(myProc == coordinatorProc) {
+      Vector<long> currentOffset(procOffset);
+      for(int i(0); i < nFABs; ++i) {
+        const int fn(NFilesIter::FileNumber(nFiles, pmap[i], groupSets));
+        hdr.m_fod[i].m_name = VisMF::BaseName(NFilesIter::FileName(fn, filePrefix));
+        hdr.m_fod[i].m_head = currentOffset[pmap[i]];
+        currentOffset[pmap[i]] += fabBytes[i];
+      }
+    }
+
+    if(currentVersion == VisMF::Header::Version_v1 ||
+       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       currentVersion == VisMF::Header::Compressed_v1)
+    {
+      hdr.CalculateMinMax(mf, coordinatorProc);
+    }
+
+    //
+    // Data files are written piecewise by several processes, so truncate
+    // any old file of the same name before anybody starts writing.
+    //
+    if(myProc == fileFirstProc[myFileNumber] && fileBytes[myFileNumber] > 0) {
+      std::ofstream ofs(myFileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+      if( ! ofs.good()) {
+        amrex::FileOpenFailed(myFileName);
+      }
+    }
+    ParallelDescriptor::Barrier("VisMF::AsyncWrite");
+
+    long bytesWritten(myBytes);
+
+    if(myBytes > 0) {
+      const long myOffset(procOffset[myProc]);
+      async_writer.push([=] () {
+          std::string err = WriteAt(myFileName, myOffset, staging, myBytes);
+          The_Pinned_Arena()->free(staging);
+          return err;
+        }, asyncMaxBuffers);
+    }
+
+    if(myProc == coordinatorProc) {
+      std::stringstream hss;
+      hss << hdr;
+      std::string hdrString(hss.str());
+      bytesWritten += hdrString.size();
+      const std::string MFHdrFileName(mf_name + TheMultiFabHdrFileSuffix);
+      async_writer.push([=] () {
+          std::ofstream MFHdrFile(MFHdrFileName.c_str(), std::ios::out | std::ios::trunc);
+          MFHdrFile.write(hdrString.data(), hdrString.size());
+          MFHdrFile.close();
+          if( ! MFHdrFile) {
+            return "VisMF::AsyncWrite: unable to write " + MFHdrFileName;
+          }
+          return std::string();
+        }, asyncMaxBuffers);
+    }
+
+    return bytesWritten;
+}
+
+void
+VisMF::AsyncWait ()
+{
+    BL_PROFILE("VisMF::AsyncWait()");
+    std::string err = async_writer.wait();
+    if ( ! err.empty()) {
+        amrex::Abort(err);
+    }
+    ParallelDescriptor::Barrier("VisMF::AsyncWait");
+}
+
+bool
+VisMF::AsyncPending ()
+{
+    return async_writer.pending();
+}
+
+
 long
 VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
                         const std::string         & mf_name,
@@ -1112,6 +1577,47 @@ VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
 }
 
 
+void
+VisMF::GatherCompressedFabs (const FabArray<FArrayBox> &mf,
+                             const Vector<long> &localFabs,
+                             const std::string &filePrefix,
+                             VisMF::Header &hdr,
+                             int procToWrite)
+{
+    const int nFABs(mf.size());
+    Vector<long> allFabs(4*nFABs);
+
+#ifdef BL_USE_MPI
+    const int nProcs(ParallelDescriptor::NProcs());
+    const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
+    std::vector<int> nmtags(nProcs, 0), offset(nProcs, 0);
+    for(int i(0); i < nFABs; ++i) {
+      nmtags[pmap[i]] += 4;
+    }
+    for(int i(1); i < nProcs; ++i) {
+      offset[i] = offset[i-1] + nmtags[i-1];
+    }
+    BL_ASSERT(localFabs.size() == nmtags[ParallelDescriptor::MyProc()]);
+
+    ParallelDescriptor::Gatherv(localFabs.dataPtr(), static_cast<int>(localFabs.size()),
+                                allFabs.dataPtr(), nmtags, offset, procToWrite);
+#else
+    allFabs = localFabs;
+#endif
+
+    if(ParallelDescriptor::MyProc() == procToWrite) {
+      hdr.m_csize.resize(nFABs);
+      for(int k(0); k < nFABs; ++k) {
+        const int idx(allFabs[4*k]);
+        const int fileNumber(allFabs[4*k+1]);
+        hdr.m_fod[idx].m_name = VisMF::BaseName(NFilesIter::FileName(fileNumber, filePrefix));
+        hdr.m_fod[idx].m_head = allFabs[4*k+2];
+        hdr.m_csize[idx]      = allFabs[4*k+3];
+      }
+    }
+}
+
+
 void
 VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 		    const std::string &filePrefix,
@@ -1340,6 +1846,118 @@ VisMF::VisMF (const std::string &fafab_name)
 
 VisMF::~VisMF ()
 {
+    for(auto &mf : m_mappedFiles) {
+      if(mf.second.first != nullptr) {
+        ::munmap(mf.second.first, mf.second.second);
+      }
+    }
+}
+
+
+char*
+VisMF::mapFile (const std::string &fileName, long &fileSize) const
+{
+    auto it = m_mappedFiles.find(fileName);
+    if(it == m_mappedFiles.end()) {
+      std::pair<char*, long> mapping(nullptr, 0);
+      int fd = ::open(fileName.c_str(), O_RDONLY);
+      if(fd >= 0) {
+        struct stat st;
+        if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+          // ---- private and writable, so the FABs can be modified in memory
+          void *p = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+          if(p != MAP_FAILED) {
+            mapping.first  = static_cast<char *>(p);
+            mapping.second = st.st_size;
+          }
+        }
+        ::close(fd);
+      }
+      it = m_mappedFiles.insert(std::make_pair(fileName, mapping)).first;
+    }
+    fileSize = it->second.second;
+    return it->second.first;
+}
+
+
+bool
+VisMF::canMapFAB () const
+{
+#if defined(AMREX_USE_GPU)
+    return false;
+#else
+    return useMMap && (NoFabHeader(m_hdr) || m_hdr.m_vers == VisMF::Header::Version_v1);
+#endif
+}
+
+
+FArrayBox
+VisMF::mapFAB (int idx,
+               int icomp) const
+{
+    BL_PROFILE("VisMF::mapFAB()");
+    BL_ASSERT(idx >= 0 && idx < m_hdr.m_ba.size());
+    BL_ASSERT(icomp >= -1 && icomp < m_hdr.m_ncomp);
+
+    long fileSize(0);
+    char *base = nullptr;
+    if(canMapFAB()) {
+      base = mapFile(VisMF::DirName(m_fafabname) + m_hdr.m_fod[idx].m_name, fileSize);
+    }
+
+    if(base != nullptr) {
+      Box fab_box(m_hdr.m_ba[idx]);
+      fab_box.grow(m_hdr.m_ngrow);
+      long head(m_hdr.m_fod[idx].m_head);
+      RealDescriptor rd;
+      bool ok(head < fileSize);
+
+      if(ok && m_hdr.m_vers == VisMF::Header::Version_v1) {
+        // ---- parse the fab header in front of the data
+        std::istringstream hss(std::string(base + head,
+                                           std::min<long>(fileSize - head, 1024)));
+        char c[4] = { 0, 0, 0, 0 };
+        hss >> c[0] >> c[1] >> c[2] >> c[3];
+        if(c[0] == 'F' && c[1] == 'A' && c[2] == 'B' && c[3] != ':') {  // ---- not the "old" format
+          hss.putback(c[3]);
+          Box bx;
+          int nvar(0);
+          hss >> rd >> bx >> nvar;
+          hss.ignore(1024, '\n');
+          ok = hss.good() && bx == fab_box && nvar == m_hdr.m_ncomp;
+          head += static_cast<std::streamoff>(hss.tellg());
+        } else {
+          ok = false;
+        }
+      } else if(ok) {
+        rd = m_hdr.m_writtenRD;
+      }
+
+      if(ok) {
+        const int  nComp(icomp == -1 ? m_hdr.m_ncomp : 1);
+        const long nItems(fab_box.numPts() * nComp);
+        const long rdBytes(rd.numBytes());
+        head += (icomp == -1 ? 0 : icomp * fab_box.numPts() * rdBytes);
+        if(head + nItems * rdBytes <= fileSize) {
+          char *src = base + head;
+          const bool native(rd == FPC::NativeRealDescriptor());
+          if(native && reinterpret_cast<std::uintptr_t>(src) % alignof(Real) == 0) {
+            return FArrayBox(fab_box, nComp, reinterpret_cast<Real *>(src));
+          }
+          FArrayBox fab(fab_box, nComp);
+          if(native) {
+            memcpy(fab.dataPtr(), src, nItems * rdBytes);
+          } else {
+            RealDescriptor::convertToNativeFormat(fab.dataPtr(), nItems, src, rd);
+          }
+          return fab;
+        }
+      }
+    }
+
+    // ---- fall back to reading a copy
+    std::unique_ptr<FArrayBox> fab(VisMF::readFAB(idx, m_fafabname, m_hdr, icomp));
+    return FArrayBox(std::move(*fab));
 }
 
 
@@ -1363,7 +1981,14 @@ VisMF::readFAB (int                  idx,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(hdr.m_vers == Header::Version_v1) {
+    if(hdr.m_vers == Header::Compressed_v1) {
+      const long npts(fab->box().numPts());
+      if(whichComp == -1) {    // ---- read all components
+        ReadCompressedFab(*infs, hdr, idx, fab->dataPtr(), 0, npts * hdr.m_ncomp);
+      } else {
+        ReadCompressedFab(*infs, hdr, idx, fab->dataPtr(), npts * whichComp, npts);
+      }
+    } else if(hdr.m_vers == Header::Version_v1) {
       if(whichComp == -1) {    // ---- read all components
         fab->readFrom(*infs);
       } else {
@@ -1413,7 +2038,9 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(hdr.m_vers == Header::Compressed_v1) {
+      ReadCompressedFab(*infs, hdr, idx, fab.dataPtr(), 0, fab.box().numPts() * fab.nComp());
+    } else if(NoFabHeader(hdr)) {
       if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fab.dataPtr(), fab.nBytes());
       } else {
@@ -1438,6 +2065,11 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 {
     BL_PROFILE("VisMF::Read()");
 
+    if(asyncWrite) {
+      // ---- the data may still be in flight
+      VisMF::AsyncWait();
+    }
+
     VisMF::Header hdr;
     Real hEndTime, hStartTime, faCopyTime(0.0);
     Real startTime(amrex::second());
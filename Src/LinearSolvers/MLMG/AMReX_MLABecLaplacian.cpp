@@ -28,6 +28,13 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
 
     const int ncomp = getNComp();
 
+    // Everything derived from the coefficients has to be rebuilt on the new grids.
+    m_needs_update = true;
+    m_acoef_changed = true;
+    m_bcoef_changed = true;
+    m_a_coeffs_sp.clear();
+    m_b_coeffs_sp.clear();
+
     m_a_coeffs.resize(m_num_amr_levels);
     m_b_coeffs.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
@@ -57,6 +64,8 @@ MLABecLaplacian::~MLABecLaplacian ()
 void
 MLABecLaplacian::setScalars (Real a, Real b) noexcept
 {
+    // The coarse a coefficients are zero if alpha was.
+    if (a != 0.0 && m_a_scalar == 0.0) m_acoef_changed = true;
     m_a_scalar = a;
     m_b_scalar = b;
     if (a == 0.0)
@@ -66,12 +75,14 @@ MLABecLaplacian::setScalars (Real a, Real b) noexcept
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_needs_update = true;
 }
 
 void
 MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
+    m_acoef_changed = true;
     m_needs_update = true;
 }
 
@@ -85,6 +96,7 @@ MLABecLaplacian::setBCoeffs (int amrlev,
             MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, icomp, 1, 0);
         }
     }
+    m_bcoef_changed = true;
     m_needs_update = true;
 }
 
@@ -112,15 +124,20 @@ MLABecLaplacian::averageDownCoeffsSameAmrLevel (Vector<MultiFab>& a,
     int nmglevs = a.size();
     for (int mglev = 1; mglev < nmglevs; ++mglev)
     {
-        if (m_a_scalar == 0.0)
-        {
-            a[mglev].setVal(0.0);
-        }
-        else
+        if (m_acoef_changed)
         {
-            amrex::average_down(a[mglev-1], a[mglev], 0, 1, mg_coarsen_ratio);
+            if (m_a_scalar == 0.0)
+            {
+                a[mglev].setVal(0.0);
+            }
+            else
+            {
+                amrex::average_down(a[mglev-1], a[mglev], 0, 1, mg_coarsen_ratio);
+            }
         }
-        
+
+        if (!m_bcoef_changed) continue;
+
         Vector<const MultiFab*> fine {AMREX_D_DECL(&(b[mglev-1][0]),
                                                    &(b[mglev-1][1]),
                                                    &(b[mglev-1][2]))};
@@ -140,15 +157,17 @@ MLABecLaplacian::averageDownCoeffsToCoarseAmrLevel (int flev)
     auto& crse_a_coeffs = m_a_coeffs[flev-1].front();
     auto& crse_b_coeffs = m_b_coeffs[flev-1].front();
 
-    if (m_a_scalar != 0.0) {
+    if (m_acoef_changed && m_a_scalar != 0.0) {
         // We coarsen from the back of flev to the front of flev-1.
         // So we use mg_coarsen_ratio.
         amrex::average_down(fine_a_coeffs, crse_a_coeffs, 0, 1, mg_coarsen_ratio);
     }
 
-    amrex::average_down_faces(amrex::GetArrOfConstPtrs(fine_b_coeffs),
-                              amrex::GetArrOfPtrs(crse_b_coeffs),
-                              mg_coarsen_ratio, 0);
+    if (m_bcoef_changed) {
+        amrex::average_down_faces(amrex::GetArrOfConstPtrs(fine_b_coeffs),
+                                  amrex::GetArrOfPtrs(crse_b_coeffs),
+                                  mg_coarsen_ratio, 0);
+    }
 }
 
 void
@@ -158,8 +177,10 @@ MLABecLaplacian::applyMetricTermsCoeffs ()
     for (int alev = 0; alev < m_num_amr_levels; ++alev)
     {
         const int mglev = 0;
-        applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        if (m_acoef_changed) {
+            applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM && m_bcoef_changed; ++idim)
         {
             applyMetricTerm(alev, mglev, m_b_coeffs[alev][mglev][idim]);
         }
@@ -167,6 +188,57 @@ MLABecLaplacian::applyMetricTermsCoeffs ()
 #endif
 }
 
+namespace {
+void copyToSinglePrecision (FabArray<BaseFab<float> >& dst, const MultiFab& src)
+{
+    const int ncomp = src.nComp();
+    dst.define(src.boxArray(), src.DistributionMap(), ncomp, src.nGrow());
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.growntilebox();
+        const auto& d = dst.array(mfi);
+        const auto& a = src.array(mfi);
+        AMREX_HOST_DEVICE_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            d(i,j,k,n) = static_cast<float>(a(i,j,k,n));
+        });
+    }
+}
+}
+
+void
+MLABecLaplacian::makeSinglePrecisionCoeffs ()
+{
+    if (!info.do_single_precision_coeffs) {
+        m_a_coeffs_sp.clear();
+        m_b_coeffs_sp.clear();
+        return;
+    }
+
+    BL_PROFILE("MLABecLaplacian::makeSinglePrecisionCoeffs()");
+
+    const bool all = m_a_coeffs_sp.empty();
+    m_a_coeffs_sp.resize(m_num_amr_levels);
+    m_b_coeffs_sp.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_a_coeffs_sp[amrlev].resize(m_num_mg_levels[amrlev]);
+        m_b_coeffs_sp[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            if (all || m_acoef_changed) {
+                copyToSinglePrecision(m_a_coeffs_sp[amrlev][mglev], m_a_coeffs[amrlev][mglev]);
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM && (all || m_bcoef_changed); ++idim) {
+                copyToSinglePrecision(m_b_coeffs_sp[amrlev][mglev][idim], m_b_coeffs[amrlev][mglev][idim]);
+            }
+        }
+    }
+}
+
 void
 MLABecLaplacian::prepareForSolve ()
 {
@@ -179,7 +251,18 @@ MLABecLaplacian::prepareForSolve ()
 #endif
 
     averageDownCoeffs();
+    makeSinglePrecisionCoeffs();
 
+    updateSingularFlag();
+
+    m_acoef_changed = false;
+    m_bcoef_changed = false;
+    m_needs_update = false;
+}
+
+void
+MLABecLaplacian::updateSingularFlag ()
+{
     m_is_singular.clear();
     m_is_singular.resize(m_num_amr_levels, false);
     auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
@@ -204,7 +287,6 @@ MLABecLaplacian::prepareForSolve ()
         }
     }
 
-    m_needs_update = false;
 }
 
 void
@@ -212,10 +294,24 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
 {
     BL_PROFILE("MLABecLaplacian::Fapply()");
 
-    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
-    AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
-                 const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
-                 const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+    if (useSinglePrecision(mglev, false)) {
+        FapplyImpl(amrlev, mglev, out, in, m_a_coeffs_sp[amrlev][mglev],
+                   amrex::GetArrOfConstPtrs(m_b_coeffs_sp[amrlev][mglev]));
+    } else {
+        FapplyImpl(amrlev, mglev, out, in, m_a_coeffs[amrlev][mglev],
+                   amrex::GetArrOfConstPtrs(m_b_coeffs[amrlev][mglev]));
+    }
+}
+
+template <class MF>
+void
+MLABecLaplacian::FapplyImpl (int amrlev, int mglev, MultiFab& out, const MultiFab& in,
+                             const MF& acoef,
+                             const Array<MF const*,AMREX_SPACEDIM>& bcoef) const
+{
+    AMREX_D_TERM(const auto& bxcoef = *bcoef[0];,
+                 const auto& bycoef = *bcoef[1];,
+                 const auto& bzcoef = *bcoef[2];);
 
     const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
 
@@ -286,11 +382,76 @@ void
 MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
 {
     BL_PROFILE("MLABecLaplacian::Fsmooth()");
+    FsmoothRestrict(amrlev, mglev, sol, rhs, redblack, nullptr);
+}
 
-    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
-    AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
-                 const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
-                 const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+void
+MLABecLaplacian::smoothResidualRestriction (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                                            MultiFab& crse, int nsmooth, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLABecLaplacian::smoothResidualRestriction()");
+
+    AMREX_ASSERT(nsmooth > 0);
+
+    for (int i = 0; i < nsmooth-1; ++i) {
+        smooth(amrlev, mglev, sol, rhs, skip_fillboundary);
+        skip_fillboundary = false;
+    }
+
+    // The residual is restricted into a coarsened copy of the fine layout,
+    // unless crse already has it.
+    BoxArray cba = amrex::coarsen(sol.boxArray(), 2);
+    MultiFab crse_tmp;
+    MultiFab* pcrse = &crse;
+    if (cba != crse.boxArray() || sol.DistributionMap() != crse.DistributionMap()) {
+        crse_tmp.define(cba, sol.DistributionMap(), crse.nComp(), 0);
+        pcrse = &crse_tmp;
+    }
+
+    applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution, nullptr, skip_fillboundary);
+    FsmoothRestrict(amrlev, mglev, sol, rhs, 0, nullptr);
+    applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution);
+    FsmoothRestrict(amrlev, mglev, sol, rhs, 1, pcrse);
+
+    // The coarse cells next to box boundaries need the ghost cells of the
+    // updated solution.
+    applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution);
+
+    if (useSinglePrecision(mglev, true)) {
+        residRestrictShellImpl(amrlev, mglev, *pcrse, sol, rhs, m_a_coeffs_sp[amrlev][mglev],
+                               amrex::GetArrOfConstPtrs(m_b_coeffs_sp[amrlev][mglev]));
+    } else {
+        residRestrictShellImpl(amrlev, mglev, *pcrse, sol, rhs, m_a_coeffs[amrlev][mglev],
+                               amrex::GetArrOfConstPtrs(m_b_coeffs[amrlev][mglev]));
+    }
+
+    if (pcrse != &crse) {
+        crse.ParallelCopy(crse_tmp);
+    }
+}
+
+void
+MLABecLaplacian::FsmoothRestrict (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                                  int redblack, MultiFab* crse) const
+{
+    if (useSinglePrecision(mglev, true)) {
+        FsmoothRestrictImpl(amrlev, mglev, sol, rhs, redblack, crse, m_a_coeffs_sp[amrlev][mglev],
+                            amrex::GetArrOfConstPtrs(m_b_coeffs_sp[amrlev][mglev]));
+    } else {
+        FsmoothRestrictImpl(amrlev, mglev, sol, rhs, redblack, crse, m_a_coeffs[amrlev][mglev],
+                            amrex::GetArrOfConstPtrs(m_b_coeffs[amrlev][mglev]));
+    }
+}
+
+template <class MF>
+void
+MLABecLaplacian::FsmoothRestrictImpl (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                                      int redblack, MultiFab* crse, const MF& acoef,
+                                      const Array<MF const*,AMREX_SPACEDIM>& bcoef) const
+{
+    AMREX_D_TERM(const auto& bxcoef = *bcoef[0];,
+                 const auto& bycoef = *bcoef[1];,
+                 const auto& bzcoef = *bcoef[2];);
     const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
     const auto& maskvals  = m_maskvals [amrlev][mglev];
 
@@ -325,8 +486,15 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                  const Real dhz = m_b_scalar/(h[2]*h[2]));
     const Real alpha = m_a_scalar;
 
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+    const Real bscalar = m_b_scalar;
+
+    // The fused sweep needs whole boxes.
     MFItInfo mfi_info;
-    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+    if (Gpu::notInLaunchRegion()) {
+        if (crse == nullptr) mfi_info.EnableTiling();
+        mfi_info.SetDynamic(true);
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -365,44 +533,105 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 #endif
 #endif
 
-#if (AMREX_SPACEDIM == 1)
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+        // Fused, the half sweep goes plane by plane along the last direction.
+        // Once plane k is done, the residual of fine planes up to k-1 is final
+        // in the interior of the box and coarse plane k/2-1 can be restricted.
+        constexpr int d = AMREX_SPACEDIM-1;
+        const Box cinterior = amrex::grow(amrex::coarsen(vbx,2),-1);
+        const int plo = (crse == nullptr) ? 0 : vbx.smallEnd(d);
+        const int phi = (crse == nullptr) ? 0 : vbx.bigEnd(d);
+        for (int k = plo; k <= phi; ++k)
         {
-            abec_gsrb(thread_box, solnfab, rhsfab, alpha, dhx,
-                      afab, bxfab,
-                      f0fab, m0,
-                      f1fab, m1,
-                      vbx, nc, redblack);
-        });
+            Box sbx = tbx;
+            if (crse != nullptr) sbx.setRange(d, k);
+
+#if (AMREX_SPACEDIM == 1)
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( sbx, thread_box,
+            {
+                abec_gsrb(thread_box, solnfab, rhsfab, alpha, dhx,
+                          afab, bxfab,
+                          f0fab, m0,
+                          f1fab, m1,
+                          vbx, nc, redblack);
+            });
 #endif
 
 #if (AMREX_SPACEDIM == 2)
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
-        {
-            abec_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy,
-                      afab, bxfab, byfab,
-                      f0fab, m0,
-                      f1fab, m1,
-                      f2fab, m2,
-                      f3fab, m3,
-                      vbx, nc, redblack);
-        });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( sbx, thread_box,
+            {
+                abec_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy,
+                          afab, bxfab, byfab,
+                          f0fab, m0,
+                          f1fab, m1,
+                          f2fab, m2,
+                          f3fab, m3,
+                          vbx, nc, redblack);
+            });
 #endif
 
 #if (AMREX_SPACEDIM == 3)
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
-        {
-            abec_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy, dhz,
-                      afab, bxfab, byfab, bzfab,
-                      f0fab, m0,
-                      f1fab, m1,
-                      f2fab, m2,
-                      f3fab, m3,
-                      f4fab, m4,
-                      f5fab, m5,
-                      vbx, nc, redblack);
-        });
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( sbx, thread_box,
+            {
+                abec_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy, dhz,
+                          afab, bxfab, byfab, bzfab,
+                          f0fab, m0,
+                          f1fab, m1,
+                          f2fab, m2,
+                          f3fab, m3,
+                          f4fab, m4,
+                          f5fab, m5,
+                          vbx, nc, redblack);
+            });
 #endif
+
+            const int kc = k/2 - 1;
+            if (crse != nullptr && k % 2 == 0 &&
+                kc >= cinterior.smallEnd(d) && kc <= cinterior.bigEnd(d))
+            {
+                Box cbx = cinterior;
+                cbx.setRange(d, kc);
+                mlabeclap_resid_restrict(cbx, crse->array(mfi), solnfab, rhsfab, afab,
+                                         AMREX_D_DECL(bxfab,byfab,bzfab),
+                                         dxinv, alpha, bscalar, nc);
+            }
+        }
+    }
+}
+
+template <class MF>
+void
+MLABecLaplacian::residRestrictShellImpl (int amrlev, int mglev, MultiFab& crse,
+                                         const MultiFab& sol, const MultiFab& rhs,
+                                         const MF& acoef,
+                                         const Array<MF const*,AMREX_SPACEDIM>& bcoef) const
+{
+    AMREX_D_TERM(const auto& bxcoef = *bcoef[0];,
+                 const auto& bycoef = *bcoef[1];,
+                 const auto& bzcoef = *bcoef[2];);
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+    const Real ascalar = m_a_scalar;
+    const Real bscalar = m_b_scalar;
+    const int ncomp = getNComp();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(crse); mfi.isValid(); ++mfi)
+    {
+        const Box& cbx = mfi.validbox();
+        const auto& cfab = crse.array(mfi);
+        const auto& xfab = sol.array(mfi);
+        const auto& bfab = rhs.array(mfi);
+        const auto& afab = acoef.array(mfi);
+        AMREX_D_TERM(const auto& bxfab = bxcoef.array(mfi);,
+                     const auto& byfab = bycoef.array(mfi);,
+                     const auto& bzfab = bzcoef.array(mfi););
+
+        for (const Box& b : amrex::boxDiff(cbx, amrex::grow(cbx,-1)))
+        {
+            mlabeclap_resid_restrict(b, cfab, xfab, bfab, afab, AMREX_D_DECL(bxfab,byfab,bzfab),
+                                     dxinv, ascalar, bscalar, ncomp);
+        }
     }
 }
 
@@ -503,31 +732,12 @@ MLABecLaplacian::update ()
 #endif
 
     averageDownCoeffs();
+    makeSinglePrecisionCoeffs();
 
-    m_is_singular.clear();
-    m_is_singular.resize(m_num_amr_levels, false);
-    auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
-    auto ithi = std::find(m_hibc[0].begin(), m_hibc[0].end(), BCType::Dirichlet);
-    if (itlo == m_lobc[0].end() && ithi == m_hibc[0].end())
-    {  // No Dirichlet
-        for (int alev = 0; alev < m_num_amr_levels; ++alev)
-        {
-            if (m_domain_covered[alev])
-            {
-                if (m_a_scalar == 0.0)
-                {
-                    m_is_singular[alev] = true;
-                }
-                else
-                {
-                    Real asum = m_a_coeffs[alev].back().sum();
-                    Real amax = m_a_coeffs[alev].back().norm0();
-                    m_is_singular[alev] = (asum <= amax * 1.e-12);
-                }
-            }
-        }
-    }
+    updateSingularFlag();
 
+    m_acoef_changed = false;
+    m_bcoef_changed = false;
     m_needs_update = false;
 }
 
@@ -0,0 +1,566 @@
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <AMReX_MLAMGSolver.H>
+
+namespace amrex {
+
+namespace {
+
+constexpr int amg_coarse_size  = 64;    // Stop coarsening at this many unknowns
+constexpr int amg_max_levels   = 25;
+constexpr int amg_max_coarsest = 2048;  // Largest coarsest matrix for the dense LU
+
+Real dot (const Vector<Real>& a, const Vector<Real>& b)
+{
+    Real r = 0.0;
+    for (int i = 0, N = a.size(); i < N; ++i) {
+        r += a[i]*b[i];
+    }
+    return r;
+}
+
+}
+
+MLAMGSolver::MLAMGSolver (MLLinOp& a_lp, int a_amrlev, int a_mglev)
+    : MLGatherSolver(a_lp, a_amrlev, a_mglev)
+{}
+
+MLAMGSolver::~MLAMGSolver () {}
+
+std::string
+MLAMGSolver::summary () const
+{
+    long nnz = 0;
+    for (const auto& L : m_levels) {
+        nnz += L.A.nnz();
+    }
+    const Real complexity = m_levels.empty() ? 0.0
+        : static_cast<Real>(nnz) / static_cast<Real>(m_levels[0].A.nnz());
+    return ", " + std::to_string(m_levels.size()) + " levels, coarsest " + std::to_string(m_nc)
+        + ", operator complexity " + std::to_string(complexity);
+}
+
+bool
+MLAMGSolver::setup (const Vector<int>& rows, const Vector<int>& cols, const Vector<Real>& vals)
+{
+    BL_PROFILE("MLAMGSolver::setup()");
+
+    const int n = m_n;
+    const int pinned = m_pinned ? n-1 : -1;
+
+    m_levels.clear();
+    m_levels.resize(1);
+
+    // Compressed rows with sorted columns and repeated entries added up.  The
+    // row and column of the pinned unknown are dropped so that the matrix
+    // stays symmetric, and empty rows get a unit diagonal.
+    {
+        Vector<int> start(n+1, 0);
+        for (int e = 0, N = rows.size(); e < N; ++e) {
+            if (rows[e] != pinned && cols[e] != pinned) ++start[rows[e]+1];
+        }
+        for (int i = 0; i < n; ++i) {
+            start[i+1] += start[i];
+        }
+        Vector<std::pair<int,Real> > entries(start[n]);
+        Vector<int> pos(start.begin(), start.end()-1);
+        for (int e = 0, N = rows.size(); e < N; ++e) {
+            if (rows[e] != pinned && cols[e] != pinned) {
+                entries[pos[rows[e]]++] = std::make_pair(cols[e], vals[e]);
+            }
+        }
+
+        Matrix& A = m_levels[0].A;
+        A.nrows = A.ncols = n;
+        A.ptr.assign(n+1, 0);
+        A.col.reserve(start[n]);
+        A.val.reserve(start[n]);
+        for (int i = 0; i < n; ++i)
+        {
+            std::sort(entries.begin()+start[i], entries.begin()+start[i+1],
+                      [] (const std::pair<int,Real>& a, const std::pair<int,Real>& b)
+                      { return a.first < b.first; });
+            const int row_start = A.col.size();
+            bool has_diag = false;
+            for (int e = start[i]; e < start[i+1]; ++e) {
+                if (static_cast<int>(A.col.size()) > row_start && A.col.back() == entries[e].first) {
+                    A.val.back() += entries[e].second;
+                } else {
+                    A.col.push_back(entries[e].first);
+                    A.val.push_back(entries[e].second);
+                }
+            }
+            for (int e = row_start, N = A.col.size(); e < N; ++e) {
+                if (A.col[e] == i && A.val[e] != 0.0) has_diag = true;
+            }
+            if (static_cast<int>(A.col.size()) == row_start) {
+                A.col.push_back(i);
+                A.val.push_back(1.0);
+                has_diag = true;
+            }
+            if (!has_diag) return false;
+            A.ptr[i+1] = A.col.size();
+        }
+    }
+
+    // Smoothed aggregation hierarchy
+    Real theta = 0.08;
+    while (m_levels.back().A.nrows > amg_coarse_size &&
+           static_cast<int>(m_levels.size()) < amg_max_levels)
+    {
+        const Matrix& A = m_levels.back().A;
+        const int nf = A.nrows;
+
+        Vector<int> agg;
+        const int nc = aggregate(A, theta, agg);
+        if (nc == 0 || 10*nc > 9*nf) break;  // Coarsening has stalled
+
+        Vector<Real> diag(nf, 0.0);
+        Real rho = 0.0;  // Gershgorin bound of the spectral radius of D^{-1} A
+        for (int i = 0; i < nf; ++i) {
+            Real s = 0.0;
+            for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+                if (A.col[e] == i) diag[i] += A.val[e];
+                s += std::abs(A.val[e]);
+            }
+            if (diag[i] != 0.0) rho = std::max(rho, s/std::abs(diag[i]));
+        }
+        const Real omega = (rho > 0.0) ? (4.0/3.0)/rho : 0.0;
+
+        // P = (I - omega D^{-1} A) P_tent with the piecewise constant P_tent
+        Matrix P;
+        P.nrows = nf;
+        P.ncols = nc;
+        P.ptr.assign(nf+1, 0);
+        Vector<int> mark(nc, -1);
+        for (int i = 0; i < nf; ++i)
+        {
+            const int row_start = P.col.size();
+            auto add = [&] (int j, Real v) {
+                if (mark[j] < row_start) {
+                    mark[j] = P.col.size();
+                    P.col.push_back(j);
+                    P.val.push_back(v);
+                } else {
+                    P.val[mark[j]] += v;
+                }
+            };
+            if (agg[i] >= 0) add(agg[i], 1.0);
+            if (diag[i] != 0.0) {
+                const Real f = omega/diag[i];
+                for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+                    const int ac = agg[A.col[e]];
+                    if (ac >= 0) add(ac, -f*A.val[e]);
+                }
+            }
+            P.ptr[i+1] = P.col.size();
+        }
+
+        Matrix R = transpose(P);
+        Matrix Ac = multiply(R, multiply(A, P));
+
+        m_levels.back().P = std::move(P);
+        m_levels.back().R = std::move(R);
+        m_levels.emplace_back();
+        m_levels.back().A = std::move(Ac);
+
+        theta *= 0.5;
+    }
+
+    for (auto& L : m_levels)
+    {
+        const int nl = L.A.nrows;
+        L.idiag.assign(nl, 0.0);
+        for (int i = 0; i < nl; ++i) {
+            for (int e = L.A.ptr[i]; e < L.A.ptr[i+1]; ++e) {
+                if (L.A.col[e] == i) L.idiag[i] += L.A.val[e];
+            }
+            L.idiag[i] = (L.idiag[i] != 0.0) ? 1.0/L.idiag[i] : 0.0;
+        }
+        L.x.resize(nl);
+        L.b.resize(nl);
+        L.r.resize(nl);
+    }
+
+    for (auto* v : {&m_x, &m_r, &m_rh, &m_p, &m_ph, &m_v, &m_s, &m_sh, &m_t}) {
+        v->resize(n);
+    }
+
+    return factorCoarsest();
+}
+
+int
+MLAMGSolver::aggregate (const Matrix& A, Real theta, Vector<int>& agg)
+{
+    const int n = A.nrows;
+
+    Vector<Real> diag(n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+            if (A.col[e] == i) diag[i] += A.val[e];
+        }
+    }
+
+    // Strong connections, |a_ij| >= theta sqrt(|a_ii a_jj|)
+    Vector<int> sptr(n+1, 0), scol;
+    scol.reserve(A.nnz());
+    for (int i = 0; i < n; ++i) {
+        for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+            const int j = A.col[e];
+            if (j != i && A.val[e] != 0.0 &&
+                std::abs(A.val[e]) >= theta*std::sqrt(std::abs(diag[i]*diag[j])))
+            {
+                scol.push_back(j);
+            }
+        }
+        sptr[i+1] = scol.size();
+    }
+
+    // -1: left out, because there are no strong connections; -2: not yet aggregated
+    agg.resize(n);
+    for (int i = 0; i < n; ++i) {
+        agg[i] = (sptr[i+1] > sptr[i]) ? -2 : -1;
+    }
+
+    int nagg = 0;
+
+    // Phase 1: aggregates of the unknowns whose strong neighborhood is free
+    for (int i = 0; i < n; ++i)
+    {
+        if (agg[i] != -2) continue;
+        bool free = true;
+        for (int e = sptr[i]; e < sptr[i+1] && free; ++e) {
+            free = agg[scol[e]] < 0;
+        }
+        if (free) {
+            agg[i] = nagg;
+            for (int e = sptr[i]; e < sptr[i+1]; ++e) {
+                agg[scol[e]] = nagg;
+            }
+            ++nagg;
+        }
+    }
+
+    // Phase 2: join a neighboring aggregate from phase 1
+    const Vector<int> agg1 = agg;
+    for (int i = 0; i < n; ++i)
+    {
+        if (agg[i] != -2) continue;
+        for (int e = sptr[i]; e < sptr[i+1]; ++e) {
+            if (agg1[scol[e]] >= 0) {
+                agg[i] = agg1[scol[e]];
+                break;
+            }
+        }
+    }
+
+    // Phase 3: aggregates of what is left
+    for (int i = 0; i < n; ++i)
+    {
+        if (agg[i] != -2) continue;
+        agg[i] = nagg;
+        for (int e = sptr[i]; e < sptr[i+1]; ++e) {
+            if (agg[scol[e]] == -2) agg[scol[e]] = nagg;
+        }
+        ++nagg;
+    }
+
+    return nagg;
+}
+
+MLAMGSolver::Matrix
+MLAMGSolver::multiply (const Matrix& a, const Matrix& b)
+{
+    AMREX_ASSERT(a.ncols == b.nrows);
+
+    Matrix c;
+    c.nrows = a.nrows;
+    c.ncols = b.ncols;
+    c.ptr.assign(c.nrows+1, 0);
+    c.col.reserve(a.nnz());
+    c.val.reserve(a.nnz());
+
+    Vector<int> mark(b.ncols, -1);
+    for (int i = 0; i < a.nrows; ++i)
+    {
+        const int row_start = c.col.size();
+        for (int ea = a.ptr[i]; ea < a.ptr[i+1]; ++ea) {
+            const int k = a.col[ea];
+            const Real av = a.val[ea];
+            for (int eb = b.ptr[k]; eb < b.ptr[k+1]; ++eb) {
+                const int j = b.col[eb];
+                if (mark[j] < row_start) {
+                    mark[j] = c.col.size();
+                    c.col.push_back(j);
+                    c.val.push_back(av*b.val[eb]);
+                } else {
+                    c.val[mark[j]] += av*b.val[eb];
+                }
+            }
+        }
+        c.ptr[i+1] = c.col.size();
+    }
+    return c;
+}
+
+MLAMGSolver::Matrix
+MLAMGSolver::transpose (const Matrix& a)
+{
+    Matrix t;
+    t.nrows = a.ncols;
+    t.ncols = a.nrows;
+    t.ptr.assign(t.nrows+1, 0);
+    for (int e = 0, N = a.nnz(); e < N; ++e) {
+        ++t.ptr[a.col[e]+1];
+    }
+    for (int i = 0; i < t.nrows; ++i) {
+        t.ptr[i+1] += t.ptr[i];
+    }
+    t.col.resize(a.nnz());
+    t.val.resize(a.nnz());
+    Vector<int> pos(t.ptr.begin(), t.ptr.end()-1);
+    for (int i = 0; i < a.nrows; ++i) {
+        for (int e = a.ptr[i]; e < a.ptr[i+1]; ++e) {
+            const int p = pos[a.col[e]]++;
+            t.col[p] = i;
+            t.val[p] = a.val[e];
+        }
+    }
+    return t;
+}
+
+void
+MLAMGSolver::apply (const Matrix& a, const Vector<Real>& x, Vector<Real>& y)
+{
+    for (int i = 0; i < a.nrows; ++i) {
+        Real s = 0.0;
+        for (int e = a.ptr[i]; e < a.ptr[i+1]; ++e) {
+            s += a.val[e]*x[a.col[e]];
+        }
+        y[i] = s;
+    }
+}
+
+void
+MLAMGSolver::residual (const Matrix& a, const Vector<Real>& x, const Vector<Real>& b,
+                       Vector<Real>& r)
+{
+    for (int i = 0; i < a.nrows; ++i) {
+        Real s = b[i];
+        for (int e = a.ptr[i]; e < a.ptr[i+1]; ++e) {
+            s -= a.val[e]*x[a.col[e]];
+        }
+        r[i] = s;
+    }
+}
+
+bool
+MLAMGSolver::factorCoarsest ()
+{
+    BL_PROFILE("MLAMGSolver::factorCoarsest()");
+
+    const Matrix& A = m_levels.back().A;
+    const int n = A.nrows;
+    m_nc = n;
+    if (n > amg_max_coarsest) return false;
+
+    m_lu.assign(static_cast<long>(n)*n, 0.0);
+    Real amax = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+            m_lu[static_cast<long>(i)*n+A.col[e]] += A.val[e];
+            amax = std::max(amax, std::abs(A.val[e]));
+        }
+    }
+
+    // LU with partial pivoting.  A column without a usable pivot, which
+    // happens for singular problems, is skipped and its unknown set to zero
+    // in the solve.
+    m_piv.resize(n);
+    for (int k = 0; k < n; ++k)
+    {
+        int p = k;
+        for (int i = k+1; i < n; ++i) {
+            if (std::abs(m_lu[static_cast<long>(i)*n+k]) > std::abs(m_lu[static_cast<long>(p)*n+k])) {
+                p = i;
+            }
+        }
+        m_piv[k] = p;
+        if (p != k) {
+            std::swap_ranges(m_lu.begin()+static_cast<long>(k)*n, m_lu.begin()+static_cast<long>(k+1)*n,
+                             m_lu.begin()+static_cast<long>(p)*n);
+        }
+        Real* rk = m_lu.data() + static_cast<long>(k)*n;
+        if (!(std::abs(rk[k]) > 1.e-12*amax)) {
+            rk[k] = 0.0;
+            continue;
+        }
+        for (int i = k+1; i < n; ++i)
+        {
+            Real* ri = m_lu.data() + static_cast<long>(i)*n;
+            if (ri[k] == 0.0) continue;
+            const Real l = ri[k] / rk[k];
+            ri[k] = l;
+            for (int j = k+1; j < n; ++j) {
+                ri[j] -= l*rk[j];
+            }
+        }
+    }
+    return true;
+}
+
+void
+MLAMGSolver::solveCoarsest (Vector<Real>& x) const
+{
+    const int n = m_nc;
+    for (int k = 0; k < n; ++k) {
+        if (m_piv[k] != k) std::swap(x[k], x[m_piv[k]]);
+    }
+    for (int i = 1; i < n; ++i) {
+        const Real* ri = m_lu.data() + static_cast<long>(i)*n;
+        Real s = x[i];
+        for (int j = 0; j < i; ++j) {
+            s -= ri[j]*x[j];
+        }
+        x[i] = s;
+    }
+    for (int i = n-1; i >= 0; --i) {
+        const Real* ri = m_lu.data() + static_cast<long>(i)*n;
+        if (ri[i] == 0.0) {
+            x[i] = 0.0;
+            continue;
+        }
+        Real s = x[i];
+        for (int j = i+1; j < n; ++j) {
+            s -= ri[j]*x[j];
+        }
+        x[i] = s / ri[i];
+    }
+}
+
+void
+MLAMGSolver::vcycle (int lev)
+{
+    Level& L = m_levels[lev];
+
+    if (lev == static_cast<int>(m_levels.size())-1) {
+        L.x = L.b;
+        solveCoarsest(L.x);
+        return;
+    }
+
+    const Matrix& A = L.A;
+    const int n = A.nrows;
+
+    // Forward Gauss-Seidel starting from zero
+    std::fill(L.x.begin(), L.x.end(), 0.0);
+    for (int i = 0; i < n; ++i) {
+        Real s = L.b[i];
+        for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+            s -= A.val[e]*L.x[A.col[e]];
+        }
+        L.x[i] += s*L.idiag[i];
+    }
+
+    residual(A, L.x, L.b, L.r);
+    Level& C = m_levels[lev+1];
+    apply(L.R, L.r, C.b);
+    vcycle(lev+1);
+    for (int i = 0; i < n; ++i) {
+        Real s = 0.0;
+        for (int e = L.P.ptr[i]; e < L.P.ptr[i+1]; ++e) {
+            s += L.P.val[e]*C.x[L.P.col[e]];
+        }
+        L.x[i] += s;
+    }
+
+    // Backward Gauss-Seidel, so that the cycle is symmetric
+    for (int i = n-1; i >= 0; --i) {
+        Real s = L.b[i];
+        for (int e = A.ptr[i]; e < A.ptr[i+1]; ++e) {
+            s -= A.val[e]*L.x[A.col[e]];
+        }
+        L.x[i] += s*L.idiag[i];
+    }
+}
+
+void
+MLAMGSolver::precond (const Vector<Real>& v, Vector<Real>& z)
+{
+    m_levels[0].b = v;
+    vcycle(0);
+    z = m_levels[0].x;
+}
+
+void
+MLAMGSolver::solveRoot (Vector<Real>& buf)
+{
+    BL_PROFILE("MLAMGSolver::solveRoot()");
+
+    const int n = m_n;
+    const Matrix& A = m_levels[0].A;
+
+    if (m_pinned) buf[n-1] = 0.0;
+
+    const Real bnorm = std::sqrt(dot(buf, buf));
+    std::fill(m_x.begin(), m_x.end(), 0.0);
+    if (bnorm == 0.0) {
+        std::fill(buf.begin(), buf.end(), 0.0);
+        return;
+    }
+    const Real eps = m_reltol*bnorm;
+
+    // Right preconditioned BiCGStab
+    m_r = buf;
+    m_rh = m_r;
+    std::fill(m_p.begin(), m_p.end(), 0.0);
+    std::fill(m_v.begin(), m_v.end(), 0.0);
+    Real rho = 1.0, alpha = 1.0, omega = 1.0;
+    Real rnorm = bnorm;
+    int iter = 1;
+    for ( ; iter <= m_maxiter; ++iter)
+    {
+        const Real rho1 = dot(m_rh, m_r);
+        if (rho1 == 0.0) break;
+        const Real beta = (rho1/rho)*(alpha/omega);
+        for (int i = 0; i < n; ++i) {
+            m_p[i] = m_r[i] + beta*(m_p[i] - omega*m_v[i]);
+        }
+        precond(m_p, m_ph);
+        apply(A, m_ph, m_v);
+        const Real rhv = dot(m_rh, m_v);
+        if (rhv == 0.0) break;
+        alpha = rho1/rhv;
+        for (int i = 0; i < n; ++i) {
+            m_x[i] += alpha*m_ph[i];
+            m_s[i] = m_r[i] - alpha*m_v[i];
+        }
+        rnorm = std::sqrt(dot(m_s, m_s));
+        if (rnorm <= eps) break;
+
+        precond(m_s, m_sh);
+        apply(A, m_sh, m_t);
+        const Real tt = dot(m_t, m_t);
+        if (tt == 0.0) break;
+        omega = dot(m_t, m_s)/tt;
+        for (int i = 0; i < n; ++i) {
+            m_x[i] += omega*m_sh[i];
+            m_r[i] = m_s[i] - omega*m_t[i];
+        }
+        rnorm = std::sqrt(dot(m_r, m_r));
+        rho = rho1;
+        if (rnorm <= eps || omega == 0.0) break;
+    }
+
+    if (verbose > 1 || (verbose > 0 && rnorm > eps)) {
+        amrex::AllPrint() << "MLAMGSolver: " << std::min(iter,m_maxiter) << " iterations, relative residual "
+                          << rnorm/bnorm << (rnorm > eps ? ", not converged" : "") << "\n";
+    }
+
+    buf = m_x;
+}
+
+}
@@ -69,6 +69,10 @@ MLCGSolver::solve (MultiFab&       sol,
 {
     if (solver_type == Type::BiCGStab) {
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipeCG) {
+        return solve_pipecg(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::SStepBiCGStab) {
+        return solve_sstep_bicgstab(sol,rhs,eps_rel,eps_abs);
     } else {
         return solve_cg(sol,rhs,eps_rel,eps_abs);
     }
@@ -122,7 +126,7 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         amrex::Print() << "MLCGSolver_BiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
     }
     int ret = 0, nit = 1;
-    Real rho_1 = 0, alpha = 0, omega = 0;
+    Real rho_1 = 0, alpha = 0, omega = 0, rho_next = 0;
 
     if ( rnorm0 == 0 || rnorm0 < eps_abs )
     {
@@ -137,7 +141,7 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     for (; nit <= maxiter; ++nit)
     {
-        const Real rho = dotxy(rh,r);
+        const Real rho = (nit == 1) ? dotxy(rh,r) : rho_next;
         if ( rho == 0 ) 
 	{
             ret = 1; break;
@@ -170,7 +174,21 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         //Subtract mean from s 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, s);
  
-        rnorm = norm_inf(s);
+        //
+        // Apply the operator to s while the norm of s is being reduced.
+        // The product is wasted only if the half step has converged.
+        //
+        rnorm = norm_inf(s, true);
+        {
+            auto req = ParallelAllReduce::IMax(rnorm, Lp.BottomCommunicator());
+
+            MultiFab::Copy(sh,s,0,0,ncomp,0);
+            Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            Lp.normalize(amrlev, mglev, t);
+
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            req.Wait();
+        }
 
         if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
         {
@@ -182,9 +200,6 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
         if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
 
-        MultiFab::Copy(sh,s,0,0,ncomp,0);
-        Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
-        Lp.normalize(amrlev, mglev, t);
         //
         // This is a little funky.  I want to elide one of the reductions
         // in the following two dotxy()s.  We do that by calculating the "local"
@@ -209,7 +224,19 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, r);
 
-        rnorm = norm_inf(r);
+        //
+        // Reduce the norm of r together with the next rho so that their
+        // latencies overlap.
+        //
+        rnorm = norm_inf(r, true);
+        rho_next = dotxy(rh, r, true);
+        {
+            auto req_norm = ParallelAllReduce::IMax(rnorm, Lp.BottomCommunicator());
+            auto req_rho  = ParallelAllReduce::ISum(rho_next, Lp.BottomCommunicator());
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            req_norm.Wait();
+            req_rho.Wait();
+        }
 
         if ( verbose > 2 )
         {
@@ -293,6 +320,7 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     }
 
     Real rho_1         = 0;
+    Real rho_next      = 0;
     int  ret           = 0;
     int  nit           = 1;
 
@@ -310,7 +338,7 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     {
         MultiFab::Copy(z,r,0,0,ncomp,0);
 
-        Real rho = dotxy(z,r);
+        Real rho = (nit == 1) ? dotxy(z,r) : rho_next;
 
         if ( rho == 0 )
         {
@@ -346,7 +374,20 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         }
         sxay(sol, sol, alpha, p);
         sxay(  r,   r,-alpha, q);
-        rnorm = norm_inf(r);
+
+        //
+        // Reduce the norm of r together with the next rho so that their
+        // latencies overlap.
+        //
+        rnorm = norm_inf(r, true);
+        rho_next = dotxy(r, r, true);
+        {
+            auto req_norm = ParallelAllReduce::IMax(rnorm, Lp.BottomCommunicator());
+            auto req_rho  = ParallelAllReduce::ISum(rho_next, Lp.BottomCommunicator());
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            req_norm.Wait();
+            req_rho.Wait();
+        }
 
         if ( verbose > 2 )
         {
@@ -389,6 +430,457 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+//
+// Pipelined CG (Ghysels and Vanroose, Parallel Computing 40, 2014) without
+// preconditioner.  Besides r it carries w = A r, s = A p and z = A s, so the
+// two dot products and the norm of an iteration are reduced while the
+// operator is applied to w.
+//
+int
+MLCGSolver::solve_pipecg (MultiFab&       sol,
+                          const MultiFab& rhs,
+                          Real            eps_rel,
+                          Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipecg");
+
+    const int nghost = sol.nGrow(), ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    MultiFab m(ba, dm, ncomp, nghost, MFInfo(), factory);
+    m.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab r0   (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab w    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab n    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, 0, MFInfo(), factory);
+    z.setVal(0.0);
+    s.setVal(0.0);
+    p.setVal(0.0);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,0);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    MultiFab::Copy(r0,r,0,0,ncomp,0);
+
+    sol.setVal(0);
+
+    Real       rnorm    = norm_inf(r);
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int  ret = 0;
+    int  nit = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_PipeCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    MultiFab::Copy(m,r,0,0,ncomp,0);
+    Lp.apply(amrlev, mglev, w, m, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    Real gamma_1 = 0, alpha_1 = 0;
+    bool converged = false;
+    bool restarted = false;
+
+    for (; nit <= maxiter; ++nit)
+    {
+        Real vals[2] = { dotxy(r,r,true), dotxy(w,r,true) };
+        rnorm = norm_inf(r, true);
+        {
+            auto req_dot  = ParallelAllReduce::ISum(vals, 2, Lp.BottomCommunicator());
+            auto req_norm = ParallelAllReduce::IMax(rnorm, Lp.BottomCommunicator());
+
+            MultiFab::Copy(m,w,0,0,ncomp,0);
+            Lp.apply(amrlev, mglev, n, m, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            req_dot.Wait();
+            req_norm.Wait();
+        }
+
+        //
+        // rnorm is the norm of the residual left by the previous iteration.
+        //
+        if ( nit > 1 && !restarted )
+        {
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_PipeCG:       Iteration"
+                               << std::setw(4) << nit-1
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                //
+                // The recurrences for r and w drift away from the true
+                // residual.  Check it, and restart from it if it is too large.
+                //
+                Lp.correctionResidual(amrlev, mglev, r, sol, r0, MLLinOp::BCMode::Homogeneous);
+                rnorm = norm_inf(r);
+                if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+                {
+                    converged = true;
+                    break;
+                }
+                if ( verbose > 1 )
+                {
+                    amrex::Print() << "MLCGSolver_PipeCG: restart at iteration " << nit-1
+                                   << ", true rel. err. " << rnorm/(rnorm0) << '\n';
+                }
+                MultiFab::Copy(m,r,0,0,ncomp,0);
+                Lp.apply(amrlev, mglev, w, m, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+                restarted = true;
+                continue;
+            }
+        }
+
+        const Real gamma = vals[0];
+        const Real delta = vals[1];
+
+        Real alpha, beta;
+        if ( nit == 1 || restarted )
+        {
+            beta = 0;
+            if ( delta == 0 ) { ret = 1; break; }
+            alpha = gamma/delta;
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            const Real denom = delta - beta*gamma/alpha_1;
+            if ( denom == 0 ) { ret = 1; break; }
+            alpha = gamma/denom;
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeCG:"
+                           << " nit " << nit
+                           << " gamma " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        sxay(z,   n,   beta, z);
+        sxay(s,   w,   beta, s);
+        sxay(p,   r,   beta, p);
+        sxay(sol, sol, alpha, p);
+        sxay(r,   r,  -alpha, s);
+        sxay(w,   w,  -alpha, z);
+
+        gamma_1 = gamma;
+        alpha_1 = alpha;
+        restarted = false;
+    }
+
+    if ( converged )
+    {
+        --nit;
+    }
+    else if ( ret == 0 )
+    {
+        nit = maxiter;
+        rnorm = norm_inf(r);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Final Iteration"
+                       << std::setw(4) << nit
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+
+    return ret;
+}
+
+//
+// s-step BiCGStab (Carson, Knight and Demmel, SIAM J. Sci. Comput. 35, 2013)
+// with the monomial basis.  Each outer step builds the Krylov bases
+// P = [p, Ap, ..., A^2s p] and R = [r, Ar, ..., A^(2s-1) r], reduces their
+// Gram matrix and their products with the shadow residual in one message,
+// and then runs s BiCGStab iterations on coefficient vectors.  The norm of
+// the new residual is reduced while the next bases are built.  A here is
+// the normalized operator, as in solve_bicgstab.
+//
+int
+MLCGSolver::solve_sstep_bicgstab (MultiFab&       sol,
+                                  const MultiFab& rhs,
+                                  Real            eps_rel,
+                                  Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::sstep_bicgstab");
+
+    const int nghost = sol.nGrow(), ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    const int ns = std::max(sstep,1);
+    const int np = 2*ns+1;          // P is Y[0,np)
+    const int nb = np + 2*ns;       // R is Y[np,nb)
+
+    MultiFab g(ba, dm, ncomp, nghost, MFInfo(), factory);
+    g.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, 0, MFInfo(), factory);
+    Vector<MultiFab> Y(nb);
+    for (auto& y : Y) {
+        y.define(ba, dm, ncomp, 0, MFInfo(), factory);
+    }
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,0);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,0);
+    MultiFab::Copy(p,    r,  0,0,ncomp,0);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_SStepBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+
+    int ret = 0, nit = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_SStepBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    auto apply = [&] (MultiFab& out, const MultiFab& in)
+    {
+        MultiFab::Copy(g,in,0,0,ncomp,0);
+        Lp.apply(amrlev, mglev, out, g, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, out);
+    };
+
+    // ---- A shifts the coefficients of each block by one
+    auto shift = [&] (const Vector<Real>& v, Vector<Real>& Bv)
+    {
+        std::fill(Bv.begin(), Bv.end(), 0.0);
+        for (int i = 0; i < np-1; ++i)  Bv[i+1] = v[i];
+        for (int i = np; i < nb-1; ++i) Bv[i+1] = v[i];
+    };
+
+    const int ngram = nb*(nb+1)/2;
+    Vector<Real> gram(ngram+nb);
+    Vector<Real> G(nb*nb), gt(nb);
+    Vector<Real> pc(nb), rc(nb), xc(nb), qc(nb), Bp(nb), Bq(nb), Gv(nb);
+
+    auto gdot = [&] (const Vector<Real>& a, const Vector<Real>& b) -> Real
+    {
+        // a^T G b
+        Real sm = 0.0;
+        for (int i = 0; i < nb; ++i) {
+            Real t = 0.0;
+            for (int j = 0; j < nb; ++j) t += G[i*nb+j]*b[j];
+            sm += a[i]*t;
+        }
+        return sm;
+    };
+    auto vdot = [&] (const Vector<Real>& a, const Vector<Real>& b) -> Real
+    {
+        Real sm = 0.0;
+        for (int i = 0; i < nb; ++i) sm += a[i]*b[i];
+        return sm;
+    };
+
+    ParallelDescriptor::ReduceRequest req_norm;
+    bool converged = false;
+
+    while (nit < maxiter)
+    {
+        MultiFab::Copy(Y[0], p,0,0,ncomp,0);
+        MultiFab::Copy(Y[np],r,0,0,ncomp,0);
+        for (int i = 0; i < np-1; ++i)  apply(Y[i+1], Y[i]);
+        for (int i = np; i < nb-1; ++i) apply(Y[i+1], Y[i]);
+
+        if ( nit > 0 )
+        {
+            {
+                BL_PROFILE("MLCGSolver::ParallelAllReduce");
+                req_norm.Wait();
+            }
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_SStepBiCGStab: Iteration "
+                               << std::setw(11) << nit
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        {
+            int k = 0;
+            for (int i = 0; i < nb; ++i) {
+                for (int j = i; j < nb; ++j) {
+                    gram[k++] = dotxy(Y[i],Y[j],true);
+                }
+            }
+            for (int i = 0; i < nb; ++i) {
+                gram[k++] = dotxy(Y[i],rh,true);
+            }
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(gram.data(), gram.size(), Lp.BottomCommunicator());
+        }
+        {
+            int k = 0;
+            for (int i = 0; i < nb; ++i) {
+                for (int j = i; j < nb; ++j) {
+                    G[i*nb+j] = G[j*nb+i] = gram[k++];
+                }
+            }
+            for (int i = 0; i < nb; ++i) {
+                gt[i] = gram[k++];
+            }
+        }
+
+        std::fill(pc.begin(), pc.end(), 0.0);
+        std::fill(rc.begin(), rc.end(), 0.0);
+        std::fill(xc.begin(), xc.end(), 0.0);
+        pc[0]  = 1.0;
+        rc[np] = 1.0;
+
+        Real rho = vdot(gt,rc);
+
+        for (int j = 0; j < ns && nit < maxiter; ++j)
+        {
+            ++nit;
+
+            if ( rho == 0 ) { ret = 1; break; }
+
+            shift(pc, Bp);
+            const Real rhTv = vdot(gt,Bp);
+            if ( rhTv == 0 ) { ret = 2; break; }
+            const Real alpha = rho/rhTv;
+
+            for (int i = 0; i < nb; ++i) qc[i] = rc[i] - alpha*Bp[i];
+            shift(qc, Bq);
+            const Real tt = gdot(Bq,Bq);
+            if ( tt == 0 ) { ret = 3; break; }
+            const Real omega = gdot(Bq,qc)/tt;
+            if ( omega == 0 ) { ret = 4; break; }
+
+            for (int i = 0; i < nb; ++i) {
+                xc[i] += alpha*pc[i] + omega*qc[i];
+                rc[i]  = qc[i] - omega*Bq[i];
+            }
+
+            const Real rho_new = vdot(gt,rc);
+            const Real beta = (rho_new/rho)*(alpha/omega);
+            for (int i = 0; i < nb; ++i) {
+                pc[i] = rc[i] + beta*(pc[i] - omega*Bp[i]);
+            }
+            rho = rho_new;
+        }
+
+        // ---- back to the grids: x += Y xc, r = Y rc, p = Y pc
+        r.setVal(0.0);
+        p.setVal(0.0);
+        for (int i = 0; i < nb; ++i) {
+            if (xc[i] != 0.0) MultiFab::Saxpy(sol, xc[i], Y[i], 0, 0, ncomp, 0);
+            if (rc[i] != 0.0) MultiFab::Saxpy(r,   rc[i], Y[i], 0, 0, ncomp, 0);
+            if (pc[i] != 0.0) MultiFab::Saxpy(p,   pc[i], Y[i], 0, 0, ncomp, 0);
+        }
+
+        rnorm = norm_inf(r, true);
+        req_norm = ParallelAllReduce::IMax(rnorm, Lp.BottomCommunicator());
+
+        if ( ret != 0 ) break;
+    }
+
+    if ( !converged )
+    {
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        req_norm.Wait();
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_SStepBiCGStab: Final: Iteration "
+                       << std::setw(4) << nit
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_SStepBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
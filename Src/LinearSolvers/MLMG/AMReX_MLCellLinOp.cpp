@@ -365,6 +365,66 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+void
+MLCellLinOp::smoothN (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                      int nsmooth, bool skip_fillboundary) const
+{
+    const int ng = sol.nGrow();
+    if (ng <= 1 || rhs.nGrow() < ng-1 || smoothNGrow(amrlev, mglev) != ng)
+    {
+        for (int i = 0; i < nsmooth; ++i) {
+            smooth(amrlev, mglev, sol, rhs, skip_fillboundary);
+            skip_fillboundary = false;
+        }
+        return;
+    }
+
+    BL_PROFILE("MLCellLinOp::smoothN()");
+
+    // After an exchange the ghost cells are good to a depth of ng.  Each
+    // half sweep also updates the ghost cells it can, leaving the region
+    // valid for the next one one cell narrower.
+    int nvalid = skip_fillboundary ? ng : 0;
+    for (int i = 0; i < 2*nsmooth; ++i)
+    {
+        if (nvalid == 0) {
+            sol.FillBoundary(0, getNComp(), m_geom[amrlev][mglev].periodicity());
+            nvalid = ng;
+        }
+#ifdef AMREX_SOFT_PERF_COUNTERS
+        if (i%2 == 0) perf_counters.smooth(sol);
+#endif
+        FsmoothGrown(amrlev, mglev, sol, rhs, i%2, --nvalid);
+    }
+}
+
+int
+MLCellLinOp::smoothNGrow (int amrlev, int mglev) const
+{
+    if (!info.do_deep_ghost_smoothing || !supportsDeepGhostSmoothing() || amrlev != 0
+        || mglev == NMGLevels(amrlev)-1 || !Geometry::isAllPeriodic() || !Geometry::IsCartesian())
+    {
+        return 1;
+    }
+
+    // The red/black coloring of the periodic images has to agree.
+    const Box& domain = m_geom[amrlev][mglev].Domain();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (domain.length(idim) % 2 != 0) return 1;
+    }
+
+    const BoxArray& ba = m_grids[amrlev][mglev];
+    int minlen = domain.shortside();
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        minlen = std::min(minlen, ba[i].shortside());
+    }
+
+    // The exchange latency dominates the smoothing of small boxes, the extra
+    // work in the ghost cells that of large ones.
+    const int ng = (minlen <= 16) ? 4 : ((minlen <= 32) ? 2 : 1);
+    return std::min(ng, domain.shortside());
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
@@ -454,7 +514,13 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     const int cross = isCrossStencil();
     const int tensorop = isTensorOp();
     if (!skip_fillboundary) {
-        in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(),cross);
+        if (info.do_deep_ghost_smoothing) {
+            // The stencil needs only one of the ghost cells used by smoothN.
+            in.FillBoundary(0, ncomp, IntVect(std::min(in.nGrow(),1)),
+                            m_geom[amrlev][mglev].periodicity(), cross);
+        } else {
+            in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(),cross);
+        }
     }
 
     int flagbc = bc_mode == BCMode::Inhomogeneous;
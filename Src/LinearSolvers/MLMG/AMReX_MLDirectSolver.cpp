@@ -0,0 +1,207 @@
+
+#include <algorithm>
+#include <cmath>
+
+#include <AMReX_MLDirectSolver.H>
+
+namespace amrex {
+
+MLDirectSolver::MLDirectSolver (MLLinOp& a_lp, int a_amrlev, int a_mglev)
+    : MLGatherSolver(a_lp, a_amrlev, a_mglev)
+{}
+
+MLDirectSolver::~MLDirectSolver () {}
+
+std::string
+MLDirectSolver::summary () const
+{
+    return ", bandwidth " + std::to_string(m_band);
+}
+
+bool
+MLDirectSolver::setup (const Vector<int>& rows, const Vector<int>& cols, const Vector<Real>& vals)
+{
+    reorder(rows, cols);
+    m_y.resize(m_n);
+    if (!factor(rows, cols, vals)) {
+        m_lu.clear();
+        return false;
+    }
+    return true;
+}
+
+void
+MLDirectSolver::reorder (const Vector<int>& rows, const Vector<int>& cols)
+{
+    BL_PROFILE("MLDirectSolver::reorder()");
+
+    const int n = m_n;
+
+    // Symmetrized adjacency graph in compressed row form
+    Vector<int> start(n+1, 0);
+    for (int e = 0, N = rows.size(); e < N; ++e) {
+        if (rows[e] != cols[e]) {
+            ++start[rows[e]+1];
+            ++start[cols[e]+1];
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        start[i+1] += start[i];
+    }
+    Vector<int> adj(start[n]);
+    Vector<int> pos(start.begin(), start.end()-1);
+    for (int e = 0, N = rows.size(); e < N; ++e) {
+        if (rows[e] != cols[e]) {
+            adj[pos[rows[e]]++] = cols[e];
+            adj[pos[cols[e]]++] = rows[e];
+        }
+    }
+    auto degree = [&] (int i) { return start[i+1] - start[i]; };
+
+    // Reverse Cuthill-McKee, one connected component at a time
+    Vector<int> order;
+    order.reserve(n);
+    Vector<int> mark(n, -1);
+    Vector<char> visited(n, 0);
+    Vector<int> nbrs;
+    for (int s = 0; s < n; ++s)
+    {
+        if (visited[s]) continue;
+
+        // Start from a cell far from s, which is close to the periphery.
+        int root = s;
+        {
+            Vector<int> queue{s};
+            mark[s] = s;
+            for (int q = 0; q < static_cast<int>(queue.size()); ++q) {
+                const int u = queue[q];
+                for (int e = start[u]; e < start[u+1]; ++e) {
+                    if (mark[adj[e]] != s) {
+                        mark[adj[e]] = s;
+                        queue.push_back(adj[e]);
+                    }
+                }
+            }
+            root = queue.back();
+        }
+
+        const int first = order.size();
+        order.push_back(root);
+        visited[root] = 1;
+        for (int q = first; q < static_cast<int>(order.size()); ++q) {
+            const int u = order[q];
+            nbrs.clear();
+            for (int e = start[u]; e < start[u+1]; ++e) {
+                if (!visited[adj[e]]) {
+                    visited[adj[e]] = 1;
+                    nbrs.push_back(adj[e]);
+                }
+            }
+            std::sort(nbrs.begin(), nbrs.end(),
+                      [&] (int a, int b) { return degree(a) < degree(b); });
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+
+    m_perm.resize(n);
+    for (int i = 0; i < n; ++i) {
+        m_perm[order[i]] = i;
+    }
+
+    m_band = 0;
+    for (int e = 0, N = rows.size(); e < N; ++e) {
+        m_band = std::max(m_band, std::abs(m_perm[rows[e]] - m_perm[cols[e]]));
+    }
+}
+
+bool
+MLDirectSolver::factor (const Vector<int>& rows, const Vector<int>& cols, const Vector<Real>& vals)
+{
+    BL_PROFILE("MLDirectSolver::factor()");
+
+    const int n = m_n;
+    const int b = m_band;
+    const long w = 2*b+1;
+
+    m_lu.assign(n*w, 0.0);
+    auto row = [&] (int i) { return m_lu.data() + i*w + b - i; };
+
+    Vector<char> nonzero(n, 0);
+    for (int e = 0, N = rows.size(); e < N; ++e) {
+        const int i = m_perm[rows[e]];
+        if (m_pinned && i == n-1) continue;
+        row(i)[m_perm[cols[e]]] += vals[e];
+        nonzero[i] = 1;
+    }
+    // Empty rows, e.g., covered cells, and the pinned unknown get a unit diagonal.
+    for (int i = 0; i < n; ++i) {
+        if (!nonzero[i]) row(i)[i] = 1.0;
+    }
+    if (m_pinned) {
+        row(n-1)[n-1] = 1.0;
+    }
+
+    Real dmax = 0.0;
+    for (int i = 0; i < n; ++i) {
+        dmax = std::max(dmax, std::abs(row(i)[i]));
+    }
+
+    for (int k = 0; k < n; ++k)
+    {
+        const Real* rk = row(k);
+        const Real piv = rk[k];
+        if (!(std::abs(piv) > 1.e-13*dmax)) return false;
+        const int iend = std::min(n-1, k+b);
+        for (int i = k+1; i <= iend; ++i)
+        {
+            Real* ri = row(i);
+            if (ri[k] == 0.0) continue;
+            const Real l = ri[k] / piv;
+            ri[k] = l;
+            for (int j = k+1; j <= iend; ++j) {
+                ri[j] -= l*rk[j];
+            }
+        }
+    }
+    return true;
+}
+
+void
+MLDirectSolver::solveRoot (Vector<Real>& buf)
+{
+    BL_PROFILE("MLDirectSolver::solveRoot()");
+
+    const int n = m_n;
+    const int bw = m_band;
+    const long w = 2*bw+1;
+    Real* y = m_y.data();
+    for (int i = 0; i < n; ++i) {
+        y[m_perm[i]] = buf[i];
+    }
+    if (m_pinned) y[n-1] = 0.0;
+
+    for (int i = 1; i < n; ++i) {
+        const Real* ri = m_lu.data() + i*w + bw - i;
+        Real s = y[i];
+        for (int j = std::max(0,i-bw); j < i; ++j) {
+            s -= ri[j]*y[j];
+        }
+        y[i] = s;
+    }
+    for (int i = n-1; i >= 0; --i) {
+        const Real* ri = m_lu.data() + i*w + bw - i;
+        Real s = y[i];
+        const int jend = std::min(n-1,i+bw);
+        for (int j = i+1; j <= jend; ++j) {
+            s -= ri[j]*y[j];
+        }
+        y[i] = s / ri[i];
+    }
+
+    for (int i = 0; i < n; ++i) {
+        buf[i] = y[m_perm[i]];
+    }
+}
+
+}
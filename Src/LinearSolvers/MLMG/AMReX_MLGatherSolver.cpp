@@ -0,0 +1,202 @@
+
+#include <algorithm>
+
+#include <AMReX_MLGatherSolver.H>
+#include <AMReX_MLSparseMatrix.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_Utility.H>
+
+namespace amrex {
+
+MLGatherSolver::MLGatherSolver (MLLinOp& a_lp, int a_amrlev, int a_mglev)
+    : Lp(a_lp), amrlev(a_amrlev), mglev(a_mglev)
+{}
+
+MLGatherSolver::~MLGatherSolver () {}
+
+bool
+MLGatherSolver::define (const MultiFab& mf, int max_size)
+{
+    BL_PROFILE("MLGatherSolver::define()");
+
+    const Real strt_time = amrex::second();
+
+    const BoxArray& ba = mf.boxArray();
+    const DistributionMapping& dm = mf.DistributionMap();
+
+    if (!Lp.isCellCentered() || Lp.getNComp() != 1 || mf.nComp() != 1 ||
+        ba.numPts() > max_size)
+    {
+        if (verbose > 0) {
+            amrex::Print() << name() << ": bottom level with " << ba.numPts()
+                           << " cells is not supported\n";
+        }
+        return false;
+    }
+
+    m_n = ba.numPts();
+    m_root = ParallelContext::IOProcessorSub();
+
+    // Number the cells rank by rank so that a gather lands in index order.
+    const int nprocs = ParallelContext::NProcsSub();
+    const int nboxes = ba.size();
+    Vector<int> owner(nboxes);
+    for (int i = 0; i < nboxes; ++i) {
+        owner[i] = ParallelContext::global_to_local_rank(dm[i]);
+    }
+    m_counts.assign(nprocs, 0);
+    for (int i = 0; i < nboxes; ++i) {
+        m_counts[owner[i]] += ba[i].numPts();
+    }
+    m_displs.assign(nprocs, 0);
+    for (int r = 1; r < nprocs; ++r) {
+        m_displs[r] = m_displs[r-1] + m_counts[r-1];
+    }
+
+    m_box_base.resize(nboxes);
+    Vector<int> next = m_displs;
+    for (int i = 0; i < nboxes; ++i) {
+        m_box_base[i] = next[owner[i]];
+        next[owner[i]] += ba[i].numPts();
+    }
+
+    MLSparseMatrix mat;
+    if (!Lp.assembleMatrix(amrlev, mglev, mat)) {
+        if (verbose > 0) {
+            amrex::Print() << name() << ": failed to assemble the bottom matrix\n";
+        }
+        return false;
+    }
+    AMREX_ASSERT(mat.boxArray() == ba);
+
+    // Local rows in the rank by rank numbering
+    Vector<int> rows, cols;
+    Vector<Real> vals;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const MLSparseMatrix::Block& blk = mat[mfi];
+        const int base = m_box_base[mfi.index()];
+        const int nrows = blk.ptr.size()-1;
+        for (int r = 0; r < nrows; ++r) {
+            for (int e = blk.ptr[r]; e < blk.ptr[r+1]; ++e) {
+                const int b = mat.whichBox(blk.col[e]);
+                rows.push_back(base + r);
+                cols.push_back(m_box_base[b] + static_cast<int>(blk.col[e] - mat.boxOffset(b)));
+                vals.push_back(blk.val[e]);
+            }
+        }
+    }
+
+    // Gather the rows onto the root.
+    Vector<int> grows, gcols;
+    Vector<Real> gvals;
+#ifdef BL_USE_MPI
+    const MPI_Comm comm = ParallelContext::CommunicatorSub();
+    const int root = ParallelContext::IOProcessorNumberSub();
+    int nlocal = rows.size();
+    Vector<int> nnz(nprocs), offset(nprocs, 0);
+    MPI_Gather(&nlocal, 1, MPI_INT, nnz.data(), 1, MPI_INT, root, comm);
+    if (m_root) {
+        for (int r = 1; r < nprocs; ++r) {
+            offset[r] = offset[r-1] + nnz[r-1];
+        }
+        const int ntot = offset[nprocs-1] + nnz[nprocs-1];
+        grows.resize(ntot);
+        gcols.resize(ntot);
+        gvals.resize(ntot);
+    }
+    MPI_Gatherv(rows.data(), nlocal, MPI_INT, grows.data(), nnz.data(), offset.data(),
+                MPI_INT, root, comm);
+    MPI_Gatherv(cols.data(), nlocal, MPI_INT, gcols.data(), nnz.data(), offset.data(),
+                MPI_INT, root, comm);
+    MPI_Gatherv(vals.data(), nlocal, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                gvals.data(), nnz.data(), offset.data(),
+                ParallelDescriptor::Mpi_typemap<Real>::type(), root, comm);
+#else
+    std::swap(grows, rows);
+    std::swap(gcols, cols);
+    std::swap(gvals, vals);
+#endif
+
+    m_pinned = Lp.isBottomSingular();
+
+    int ok_setup = 1;
+    if (m_root) {
+        ok_setup = setup(grows, gcols, gvals);
+        m_buf.resize(m_n);
+    }
+#ifdef BL_USE_MPI
+    MPI_Bcast(&ok_setup, 1, MPI_INT, root, comm);
+#endif
+
+    if (verbose > 0) {
+        amrex::Print() << name() << ": " << m_n << " unknowns" << summary()
+                       << (ok_setup ? "" : ", setup failed")
+                       << ", setup time " << amrex::second()-strt_time << "\n";
+    }
+
+    return ok_setup != 0;
+}
+
+void
+MLGatherSolver::solve (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLGatherSolver::solve()");
+
+    const int me = ParallelContext::MyProcSub();
+    const int offset = m_displs[me];
+    Vector<Real> local(m_counts[me]);
+
+    for (MFIter mfi(b); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& bfab = b.array(mfi);
+        int g = m_box_base[mfi.index()] - offset;
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            local[g++] = bfab(i,j,k);
+        }}}
+    }
+
+#ifdef BL_USE_MPI
+    const MPI_Comm comm = ParallelContext::CommunicatorSub();
+    const int root = ParallelContext::IOProcessorNumberSub();
+    MPI_Gatherv(local.data(), local.size(), ParallelDescriptor::Mpi_typemap<Real>::type(),
+                m_buf.data(), m_counts.data(), m_displs.data(),
+                ParallelDescriptor::Mpi_typemap<Real>::type(), root, comm);
+#else
+    std::copy(local.begin(), local.end(), m_buf.begin());
+#endif
+
+    if (m_root) {
+        solveRoot(m_buf);
+    }
+
+#ifdef BL_USE_MPI
+    MPI_Scatterv(m_buf.data(), m_counts.data(), m_displs.data(),
+                 ParallelDescriptor::Mpi_typemap<Real>::type(),
+                 local.data(), local.size(), ParallelDescriptor::Mpi_typemap<Real>::type(),
+                 root, comm);
+#else
+    std::copy(m_buf.begin(), m_buf.end(), local.begin());
+#endif
+
+    for (MFIter mfi(x); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& xfab = x.array(mfi);
+        int g = m_box_base[mfi.index()] - offset;
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            xfab(i,j,k) = local[g++];
+        }}}
+    }
+}
+
+}
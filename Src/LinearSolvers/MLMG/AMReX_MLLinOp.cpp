@@ -6,6 +6,8 @@
 #include <AMReX_Utility.H>
 #include <AMReX_MLLinOp.H>
 #include <AMReX_MLCellLinOp.H>
+#include <AMReX_MLSparseMatrix.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Machine.H>
 
@@ -136,6 +138,7 @@ MLLinOp::define (const Vector<Geometry>& a_geom,
     }
 
     info = a_info;
+    m_prepared = false;
 #ifdef AMREX_USE_EB
     if (!a_factory.empty()){
         auto f = dynamic_cast<EBFArrayBoxFactory const*>(a_factory[0]);
@@ -163,6 +166,13 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
     m_amr_ref_ratio.resize(m_num_amr_levels);
     m_num_mg_levels.resize(m_num_amr_levels);
 
+    // The levels are appended below, so drop those of a previous define.
+    m_geom.clear();
+    m_grids.clear();
+    m_dmap.clear();
+    m_factory.clear();
+    m_domain_covered.clear();
+
     m_geom.resize(m_num_amr_levels);
     m_grids.resize(m_num_amr_levels);
     m_dmap.resize(m_num_amr_levels);
@@ -704,4 +714,248 @@ MLLinOp::makePETSc () const
 }
 #endif
 
+namespace {
+
+// Deterministic test vector used to check the assembled matrix.
+inline Real probe_value (long g) noexcept
+{
+    return 1.0 + 0.5*std::sin(1.3*g + 0.7);
+}
+
+}
+
+bool
+MLLinOp::assembleMatrix (int amrlev, int mglev, MLSparseMatrix& mat) const
+{
+    BL_PROFILE("MLLinOp::assembleMatrix()");
+
+    if (!isCellCentered() || getNComp() != 1) return false;
+
+    const MPI_Comm comm = Communicator(amrlev, mglev);
+#ifdef BL_USE_MPI
+    if (comm == MPI_COMM_NULL) {
+        mat.define(m_grids[amrlev][mglev], m_dmap[amrlev][mglev], m_geom[amrlev][mglev], 1);
+        return true;
+    }
+#endif
+
+    ParallelContext::push(comm);
+    bool ok = false;
+    for (int radius = 1; radius <= 2 && !ok; ++radius) {
+        ok = probeMatrix(amrlev, mglev, radius, mat);
+    }
+    ParallelContext::pop();
+
+    return ok;
+}
+
+bool
+MLLinOp::probeMatrix (int amrlev, int mglev, int radius, MLSparseMatrix& mat) const
+{
+    const BoxArray& ba = m_grids[amrlev][mglev];
+    const DistributionMapping& dm = m_dmap[amrlev][mglev];
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+    const IntVect dlo = domain.smallEnd();
+    const IntVect dhi = domain.bigEnd();
+
+    mat.define(ba, dm, geom, radius);
+
+    // Global index of the valid cells and, through the ghost cells, of
+    // their neighbors
+    FabArray<BaseFab<long> > gidx(ba, dm, 1, radius);
+    gidx.setVal(-1);
+    for (MFIter mfi(gidx); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& g = gidx.array(mfi);
+        long n = mat.boxOffset(mfi.index());
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            g(i,j,k) = n++;
+        }}}
+    }
+    gidx.FillBoundary(geom.periodicity());
+
+    // Color the cells so that no two cells of the same color are within the
+    // stencil radius of a common cell.  Across a periodic boundary the
+    // coloring has to divide the domain length.
+    IntVect ncolor;
+    int ncolors = 1;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int len = domain.length(idim);
+        int m = 2*radius+1;
+        if (m >= len) {
+            m = len;
+        } else if (geom.isPeriodic(idim)) {
+            while (len % m != 0) ++m;
+        }
+        ncolor[idim] = m;
+        ncolors *= m;
+    }
+
+    MultiFab p (ba, dm, 1, 1, MFInfo(), *Factory(amrlev,mglev));
+    MultiFab Ap(ba, dm, 1, 0, MFInfo(), *Factory(amrlev,mglev));
+
+    // Row of each entry, before they are sorted into rows
+    LayoutData<Vector<int> > entry_row(ba, dm);
+
+    int bad = 0;
+
+    for (int color = 0; color < ncolors; ++color)
+    {
+        IntVect cv;
+        for (int idim = 0, c = color; idim < AMREX_SPACEDIM; ++idim) {
+            cv[idim] = c % ncolor[idim];
+            c /= ncolor[idim];
+        }
+
+        p.setVal(0.0);
+        for (MFIter mfi(p); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& pfab = p.array(mfi);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                bool on = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    on = on && ((iv[idim]-dlo[idim]) % ncolor[idim] == cv[idim]);
+                }
+                if (on) pfab(i,j,k) = 1.0;
+            }}}
+        }
+
+        apply(amrlev, mglev, Ap, p, BCMode::Homogeneous, StateMode::Correction);
+
+        for (MFIter mfi(Ap); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& afab = Ap.array(mfi);
+            const auto& g = gidx.array(mfi);
+            MLSparseMatrix::Block& blk = mat[mfi];
+            Vector<int>& rows = entry_row[mfi];
+            int row = 0;
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i, ++row) {
+                const Real a = afab(i,j,k);
+                if (a == 0.0) continue;
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                // The only cell of this color within the stencil radius.
+                int s[3] = {0, 0, 0};
+                bool found = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM && found; ++idim) {
+                    found = false;
+                    const int len = domain.length(idim);
+                    for (int o = -radius; o <= radius; ++o) {
+                        int c = iv[idim] + o;
+                        if (geom.isPeriodic(idim)) {
+                            c = dlo[idim] + ((c-dlo[idim]) % len + len) % len;
+                        } else if (c < dlo[idim] || c > dhi[idim]) {
+                            continue;
+                        }
+                        if ((c-dlo[idim]) % ncolor[idim] == cv[idim]) {
+                            s[idim] = o;
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+                const long col = found ? g(i+s[0],j+s[1],k+s[2]) : -1;
+                if (col < 0) {
+                    bad = 1;
+                } else {
+                    rows.push_back(row);
+                    blk.col.push_back(col);
+                    blk.val.push_back(a);
+                    blk.shift.push_back(mat.encodeShift(IntVect(AMREX_D_DECL(s[0],s[1],s[2]))));
+                }
+            }}}
+        }
+    }
+
+    // Sort the entries into rows
+    for (MFIter mfi(Ap); mfi.isValid(); ++mfi)
+    {
+        MLSparseMatrix::Block& blk = mat[mfi];
+        const Vector<int>& rows = entry_row[mfi];
+        const int nrows = mfi.validbox().numPts();
+        const int nnz = rows.size();
+        blk.ptr.assign(nrows+1, 0);
+        for (int e = 0; e < nnz; ++e) {
+            ++blk.ptr[rows[e]+1];
+        }
+        for (int r = 0; r < nrows; ++r) {
+            blk.ptr[r+1] += blk.ptr[r];
+        }
+        Vector<int> pos(blk.ptr.begin(), blk.ptr.end()-1);
+        Vector<long> col(nnz);
+        Vector<Real> val(nnz);
+        Vector<int> shift(nnz);
+        for (int e = 0; e < nnz; ++e) {
+            const int q = pos[rows[e]]++;
+            col[q] = blk.col[e];
+            val[q] = blk.val[e];
+            shift[q] = blk.shift[e];
+        }
+        std::swap(blk.col, col);
+        std::swap(blk.val, val);
+        std::swap(blk.shift, shift);
+    }
+
+    // Check the assembled rows against the operator.
+    if (!bad)
+    {
+        for (MFIter mfi(p); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& pfab = p.array(mfi);
+            long n = mat.boxOffset(mfi.index());
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                pfab(i,j,k) = probe_value(n++);
+            }}}
+        }
+
+        apply(amrlev, mglev, Ap, p, BCMode::Homogeneous, StateMode::Correction);
+
+        for (MFIter mfi(Ap); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& afab = Ap.array(mfi);
+            const MLSparseMatrix::Block& blk = mat[mfi];
+            int row = 0;
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i, ++row) {
+                Real y = 0.0, scale = 0.0;
+                for (int e = blk.ptr[row]; e < blk.ptr[row+1]; ++e) {
+                    const Real t = blk.val[e]*probe_value(blk.col[e]);
+                    y += t;
+                    scale += std::abs(t);
+                }
+                if (std::abs(afab(i,j,k)-y) > 1.e-10*scale) bad = 1;
+            }}}
+        }
+    }
+
+    ParallelAllReduce::Max(bad, ParallelContext::CommunicatorSub());
+
+    return bad == 0;
+}
+
 }
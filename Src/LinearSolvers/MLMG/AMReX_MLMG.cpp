@@ -5,6 +5,8 @@
 #include <AMReX_MLMG_F.H>
 #include <AMReX_MLMG_K.H>
 #include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLDirectSolver.H>
+#include <AMReX_MLAMGSolver.H>
 
 #ifdef AMREX_USE_PETSC
 #include <petscksp.h>
@@ -406,24 +408,44 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
 
         cor[amrlev][mglev]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
-                         skip_fillboundary);
-            skip_fillboundary = false;
-        }
 
-        // rescor = res - L(cor)
-        computeResOfCorrection(amrlev, mglev);
+        if (cor[amrlev][mglev]->nGrow() > 1) {
+            // for smoothing in the ghost cells of cor; also used on the way up
+            res[amrlev][mglev].FillBoundary(linop.Geom(amrlev,mglev).periodicity());
+        }
 
-        if (verbose >= 4)
+        if (fuse_smooth_restriction && nu1 > 0 && linop.hasFusedSmoothRestriction())
         {
-            Real norm = rescor[amrlev][mglev].norm0();
-            amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
-                           << "   DN: Norm after  smooth " << norm << "\n";
+            // res_crse = R(res - L(cor)) in the same pass as the last sweep
+            linop.smoothResidualRestriction(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                                            res[amrlev][mglev+1], nu1, skip_fillboundary);
+
+            if (verbose >= 4)
+            {
+                computeResOfCorrection(amrlev, mglev);
+                Real norm = rescor[amrlev][mglev].norm0();
+                amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
+                               << "   DN: Norm after  smooth " << norm << "\n";
+            }
         }
+        else
+        {
+            linop.smoothN(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                          nu1, skip_fillboundary);
+
+            // rescor = res - L(cor)
+            computeResOfCorrection(amrlev, mglev);
 
-        // res_crse = R(rescor_fine); this provides res/b to the level below
-        linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
+            if (verbose >= 4)
+            {
+                Real norm = rescor[amrlev][mglev].norm0();
+                amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
+                               << "   DN: Norm after  smooth " << norm << "\n";
+            }
+
+            // res_crse = R(rescor_fine); this provides res/b to the level below
+            linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
+        }
 
     }
 
@@ -483,9 +505,7 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
                            << "   UP: Norm before smooth " << norm << "\n";
         }
-        for (int i = 0; i < nu2; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
-        }
+        linop.smoothN(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev], nu2);
         if (verbose >= 4)
         {
             computeResOfCorrection(amrlev, mglev);
@@ -886,7 +906,32 @@ MLMG::actualBottomSolve ()
             makeSolvable(amrlev,mglev,*bottom_b);
         }
 
-        if (bottom_solver == BottomSolver::hypre)
+        if (bottom_solver == BottomSolver::direct &&
+            !bottomSolveWithDirect(x, *bottom_b))
+        {
+            // The level cannot be factored; switch to bicgstab permanently
+            if (verbose > 0) {
+                amrex::Print() << "MLMG: direct bottom solver not available, switching to bicgstab\n";
+            }
+            bottom_solver = BottomSolver::bicgstab;
+        }
+
+        if (bottom_solver == BottomSolver::amg &&
+            !bottomSolveWithAMG(x, *bottom_b))
+        {
+            // The hierarchy cannot be built; switch to bicgstab permanently
+            if (verbose > 0) {
+                amrex::Print() << "MLMG: AMG bottom solver not available, switching to bicgstab\n";
+            }
+            bottom_solver = BottomSolver::bicgstab;
+        }
+
+        if (bottom_solver == BottomSolver::direct ||
+            bottom_solver == BottomSolver::amg)
+        {
+            // done
+        }
+        else if (bottom_solver == BottomSolver::hypre)
         {
             bottomSolveWithHypre(x, *bottom_b);
         }
@@ -900,6 +945,10 @@ MLMG::actualBottomSolve ()
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipecg) {
+                cg_type = MLCGSolver::Type::PipeCG;
+            } else if (bottom_solver == BottomSolver::sstepbicgstab) {
+                cg_type = MLCGSolver::Type::SStepBiCGStab;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -945,6 +994,7 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
     cg_solver.setSolver(type);
     cg_solver.setVerbose(bottom_verbose);
     cg_solver.setMaxIter(bottom_maxiter);
+    cg_solver.setSStep(bottom_sstep);
 
     const Real cg_rtol = bottom_reltol;
     const Real cg_atol = -1.0;
@@ -1079,6 +1129,22 @@ MLMG::buildFineMask ()
     }
 }
 
+void
+MLMG::prepareLinOp ()
+{
+    if (!linop_prepared && !(linop.m_keep_prepared && linop.m_prepared)) {
+        linop.prepareForSolve();
+        linop.m_prepared = true;
+        direct_solver.reset();
+        amg_solver.reset();
+    } else if (linop.needsUpdate()) {
+        linop.update();
+        direct_solver.reset();
+        amg_solver.reset();
+    }
+    linop_prepared = true;
+}
+
 void
 MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs)
 {
@@ -1091,12 +1157,7 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
 
     const int ncomp = linop.getNComp();
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
 
 #ifdef AMREX_USE_HYPRE
     hypre_solver.reset();
@@ -1167,6 +1228,20 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     if (!solve_called) {
         linop.make(res, ncomp, ng);
         linop.make(rescor, ncomp, ng);
+        for (int alev = 0; alev <= finest_amr_lev; ++alev)
+        {
+            const int nmglevs = linop.NMGLevels(alev);
+            for (int mglev = 0; mglev < nmglevs; ++mglev)
+            {
+                const int sng = linop.smoothNGrow(alev, mglev);
+                if (sng > 1) {
+                    res[alev][mglev] = MultiFab(res[alev][mglev].boxArray(),
+                                                res[alev][mglev].DistributionMap(),
+                                                ncomp, sng-1, MFInfo(),
+                                                *linop.Factory(alev,mglev));
+                }
+            }
+        }
     }
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
@@ -1189,7 +1264,8 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
             if (!solve_called) {
                 cor[alev][mglev].reset(new MultiFab(res[alev][mglev].boxArray(),
                                                     res[alev][mglev].DistributionMap(),
-                                                    ncomp, ng, MFInfo(),
+                                                    ncomp, std::max(ng,linop.smoothNGrow(alev,mglev)),
+                                                    MFInfo(),
                                                     *linop.Factory(alev,mglev)));
             }
             cor[alev][mglev]->setVal(0.0);
@@ -1389,12 +1465,7 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
         }
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
     
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1461,12 +1532,7 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
         rh[alev].setVal(0.0);
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
 
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1698,6 +1764,53 @@ MLMG::getNodalSum (int amrlev, int mglev, MultiFab& mf) const
     return s1/s2;
 }
 
+bool
+MLMG::bottomSolveWithDirect (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLMG::bottomSolveWithDirect()");
+
+    const int amrlev = 0;
+    const int mglev = linop.NMGLevels(amrlev) - 1;
+
+    if (direct_solver == nullptr)
+    {
+        direct_solver.reset(new MLDirectSolver(linop, amrlev, mglev));
+        direct_solver->setVerbose(bottom_verbose);
+        if (!direct_solver->define(x, bottom_direct_max_size)) {
+            direct_solver.reset();
+        amg_solver.reset();
+            return false;
+        }
+    }
+
+    direct_solver->solve(x, b);
+    return true;
+}
+
+bool
+MLMG::bottomSolveWithAMG (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLMG::bottomSolveWithAMG()");
+
+    const int amrlev = 0;
+    const int mglev = linop.NMGLevels(amrlev) - 1;
+
+    if (amg_solver == nullptr)
+    {
+        amg_solver.reset(new MLAMGSolver(linop, amrlev, mglev));
+        amg_solver->setVerbose(bottom_verbose);
+        if (!amg_solver->define(x, bottom_amg_max_size)) {
+            amg_solver.reset();
+            return false;
+        }
+    }
+
+    amg_solver->setTolerance(bottom_reltol);
+    amg_solver->setMaxIter(bottom_maxiter);
+    amg_solver->solve(x, b);
+    return true;
+}
+
 void
 MLMG::bottomSolveWithHypre (MultiFab& x, const MultiFab& b)
 {
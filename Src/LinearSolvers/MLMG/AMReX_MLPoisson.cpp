@@ -146,6 +146,13 @@ MLPoisson::normalize (int amrlev, int mglev, MultiFab& mf) const
 
 void
 MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, int redblack) const
+{
+    FsmoothGrown(amrlev, mglev, sol, rhs, redblack, 0);
+}
+
+void
+MLPoisson::FsmoothGrown (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                         int redblack, int ngrow) const
 {
     BL_PROFILE("MLPoisson::Fsmooth()");
 
@@ -200,8 +207,10 @@ MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, i
 #endif
 #endif
 
-	const Box& tbx = mfi.tilebox();
-        const Box& vbx = mfi.validbox();
+	const Box& tbx = mfi.growntilebox(ngrow);
+        // In the ghost cells there are no boundary corrections, so the
+        // stencil must not see the box boundary there.
+        const Box vbx = (ngrow == 0) ? mfi.validbox() : amrex::grow(mfi.validbox(),ngrow+1);
         const auto& solnfab = sol.array(mfi);
         const auto& rhsfab  = rhs.array(mfi);
 
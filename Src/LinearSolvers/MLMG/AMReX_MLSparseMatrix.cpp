@@ -0,0 +1,147 @@
+
+#include <algorithm>
+
+#include <AMReX_MLSparseMatrix.H>
+
+namespace amrex {
+
+MLSparseMatrix::MLSparseMatrix (const BoxArray& ba, const DistributionMapping& dm,
+                                const Geometry& geom, int radius)
+{
+    define(ba, dm, geom, radius);
+}
+
+void
+MLSparseMatrix::define (const BoxArray& ba, const DistributionMapping& dm,
+                        const Geometry& geom, int radius)
+{
+    m_blocks = LayoutData<Block>(ba, dm);
+    m_geom = geom;
+    m_radius = radius;
+
+    const int nboxes = ba.size();
+    m_box_offset.resize(nboxes+1);
+    m_box_offset[0] = 0;
+    for (int i = 0; i < nboxes; ++i) {
+        m_box_offset[i+1] = m_box_offset[i] + ba[i].numPts();
+    }
+}
+
+long
+MLSparseMatrix::numLocalNonZeros () const
+{
+    long nnz = 0;
+    for (MFIter mfi(m_blocks); mfi.isValid(); ++mfi) {
+        nnz += m_blocks[mfi].val.size();
+    }
+    return nnz;
+}
+
+int
+MLSparseMatrix::whichBox (long g) const
+{
+    AMREX_ASSERT(g >= 0 && g < numRows());
+    auto it = std::upper_bound(m_box_offset.begin(), m_box_offset.end(), g);
+    return static_cast<int>(it - m_box_offset.begin()) - 1;
+}
+
+int
+MLSparseMatrix::encodeShift (const IntVect& s) const noexcept
+{
+    const int w = 2*m_radius+1;
+    int code = 0;
+    for (int idim = AMREX_SPACEDIM-1; idim >= 0; --idim) {
+        code = code*w + s[idim] + m_radius;
+    }
+    return code;
+}
+
+IntVect
+MLSparseMatrix::decodeShift (int code) const noexcept
+{
+    const int w = 2*m_radius+1;
+    IntVect s;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        s[idim] = code % w - m_radius;
+        code /= w;
+    }
+    return s;
+}
+
+void
+MLSparseMatrix::apply (MultiFab& y, MultiFab& x) const
+{
+    BL_PROFILE("MLSparseMatrix::apply()");
+
+    AMREX_ALWAYS_ASSERT(x.nGrow() >= m_radius && x.nComp() == 1 && y.nComp() == 1);
+
+    x.FillBoundary(m_geom.periodicity());
+
+    int nshifts = 1;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        nshifts *= 2*m_radius+1;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<long> offset(nshifts);
+        for (MFIter mfi(y); mfi.isValid(); ++mfi)
+        {
+            const Block& blk = m_blocks[mfi];
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& xfab = x.array(mfi);
+            const auto& yfab = y.array(mfi);
+
+            // Distance in memory of each stencil cell in x
+            for (int s = 0; s < nshifts; ++s) {
+                const IntVect iv = decodeShift(s);
+                offset[s] = AMREX_D_TERM(iv[0], + iv[1]*xfab.jstride, + iv[2]*xfab.kstride);
+            }
+
+            const int*  AMREX_RESTRICT ptr   = blk.ptr.data();
+            const Real* AMREX_RESTRICT val   = blk.val.data();
+            const int*  AMREX_RESTRICT shift = blk.shift.data();
+            const long* AMREX_RESTRICT off   = offset.data();
+
+            int row = 0;
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                const Real* xp = &xfab(i,j,k);
+                Real r = 0.0;
+                for (int e = ptr[row]; e < ptr[row+1]; ++e) {
+                    r += val[e]*xp[off[shift[e]]];
+                }
+                yfab(i,j,k) = r;
+                ++row;
+            }}}
+        }
+    }
+}
+
+void
+MLSparseMatrix::getTriplets (Vector<long>& rows, Vector<long>& cols, Vector<Real>& vals) const
+{
+    rows.clear();
+    cols.clear();
+    vals.clear();
+    for (MFIter mfi(m_blocks); mfi.isValid(); ++mfi)
+    {
+        const Block& blk = m_blocks[mfi];
+        const long row0 = m_box_offset[mfi.index()];
+        const int nrows = blk.ptr.size()-1;
+        for (int r = 0; r < nrows; ++r) {
+            for (int e = blk.ptr[r]; e < blk.ptr[r+1]; ++e) {
+                rows.push_back(row0+r);
+                cols.push_back(blk.col[e]);
+                vals.push_back(blk.val[e]);
+            }
+        }
+    }
+}
+
+}
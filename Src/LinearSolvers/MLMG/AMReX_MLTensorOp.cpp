@@ -101,6 +101,7 @@ MLTensorOp::prepareForSolve ()
                            m_kappa[amrlev][0][idim], 0, icomp, 1, 0);
         }
     }
+    m_bcoef_changed = true;
 
     MLABecLaplacian::prepareForSolve();
 }
@@ -0,0 +1,285 @@
+//
+// Regrids a moving refined region with amr.incremental_regrid = 1 and
+// checks that AmrLevel::FillPatch, which then copies the unchanged grids
+// locally, gives the same data as a FillPatchIterator over all grids.
+// The state has ghost cells.  Also checks that the distribution of the
+// regridded levels is balanced about as well as distributing them anew.
+//
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_PROB_AMR_F.H>
+
+using namespace amrex;
+
+namespace {
+    const int  State_Type = 0;
+    const int  NComp      = 2;
+    const int  NGrow      = 2;
+
+    Real max_error = 0.0;
+    long nfilled   = 0;
+    long nkept     = 0;
+    long nnew      = 0;
+    Real min_eff_ratio = 1.0;
+
+    Real efficiency (const BoxArray& ba, const DistributionMapping& dm)
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+        std::vector<long> cells(nprocs, 0L);
+        long total = 0;
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            cells[dm[i]] += ba[i].numPts();
+            total += ba[i].numPts();
+        }
+        const long cmax = *std::max_element(cells.begin(), cells.end());
+        return static_cast<Real>(total) / (static_cast<Real>(nprocs)*static_cast<Real>(cmax));
+    }
+
+    void fill_state (MultiFab& S, const Geometry& geom, Real time)
+    {
+        const Real* dx = geom.CellSize();
+        const Real* lo = geom.ProbLo();
+        for (MFIter mfi(S); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto& a = S.array(mfi);
+            const auto blo = lbound(bx);
+            const auto bhi = ubound(bx);
+            for (int n = 0; n < NComp; ++n) {
+            for (int k = blo.z; k <= bhi.z; ++k) {
+            for (int j = blo.y; j <= bhi.y; ++j) {
+            for (int i = blo.x; i <= bhi.x; ++i) {
+                const Real x = lo[0] + (i+0.5)*dx[0];
+                const Real y = lo[1] + (j+0.5)*dx[1];
+                const Real z = lo[2] + (k+0.5)*dx[2];
+                a(i,j,k,n) = std::sin(6.0*x + time) * std::cos(4.0*y - n) + z*z;
+            }}}}
+        }
+    }
+
+    void nullfill (Real* data, AMREX_ARLIM_P(lo), AMREX_ARLIM_P(hi),
+                   const int* dom_lo, const int* dom_hi,
+                   const Real* dx, const Real* grd_lo,
+                   const Real* time, const int* bc) {}
+}
+
+class RegridTestLevel
+    :
+    public AmrLevel
+{
+public:
+
+    RegridTestLevel () {}
+
+    RegridTestLevel (Amr&                       papa,
+                     int                        lev,
+                     const Geometry&            level_geom,
+                     const BoxArray&            bl,
+                     const DistributionMapping& dm,
+                     Real                       time)
+        :
+        AmrLevel(papa,lev,level_geom,bl,dm,time) {}
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(State_Type,IndexType::TheCellType(),
+                               StateDescriptor::Point,NGrow,NComp,
+                               &cell_cons_interp);
+        int lo_bc[AMREX_SPACEDIM];
+        int hi_bc[AMREX_SPACEDIM];
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        BCRec bc(lo_bc, hi_bc);
+        for (int n = 0; n < NComp; ++n) {
+            desc_lst.setComponent(State_Type, n, "phi"+std::to_string(n), bc,
+                                  StateDescriptor::BndryFunc(nullfill));
+        }
+    }
+
+    static void variableCleanUp () { desc_lst.clear(); }
+
+    virtual void computeInitialDt (int                    finest_level,
+                                   int                    sub_cycle,
+                                   Vector<int>&           n_cycle,
+                                   const Vector<IntVect>& ref_ratio,
+                                   Vector<Real>&          dt_level,
+                                   Real                   stop_time) override
+    {
+        int n_factor = 1;
+        for (int i = 0; i <= finest_level; ++i) {
+            n_factor *= n_cycle[i];
+            dt_level[i] = 0.1/n_factor;
+        }
+    }
+
+    virtual void computeNewDt (int                    finest_level,
+                               int                    sub_cycle,
+                               Vector<int>&           n_cycle,
+                               const Vector<IntVect>& ref_ratio,
+                               Vector<Real>&          dt_min,
+                               Vector<Real>&          dt_level,
+                               Real                   stop_time,
+                               int                    post_regrid_flag) override
+    {
+        computeInitialDt(finest_level, sub_cycle, n_cycle, ref_ratio, dt_level, stop_time);
+    }
+
+    virtual Real advance (Real time, Real dt, int iteration, int ncycle) override
+    {
+        state[State_Type].allocOldData();
+        state[State_Type].swapTimeLevels(dt);
+        fill_state(get_new_data(State_Type), geom, time+dt);
+        return dt;
+    }
+
+    virtual void post_timestep (int iteration) override {}
+    virtual void post_regrid (int lbase, int new_finest) override {}
+    virtual void post_init (Real stop_time) override {}
+
+    virtual void initData () override
+    {
+        fill_state(get_new_data(State_Type), geom, state[State_Type].curTime());
+    }
+
+    virtual void init (AmrLevel& old) override
+    {
+        const Real cur_time  = old.get_state_data(State_Type).curTime();
+        const Real prev_time = old.get_state_data(State_Type).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, parent->dtLevel(level));
+
+        MultiFab& S_new = get_new_data(State_Type);
+        FillPatch(old, S_new, 0, cur_time, State_Type, 0, NComp);
+
+        // The same fill through a FillPatchIterator over all grids
+        FillPatchIterator fpi(old, S_new, 0, cur_time, State_Type, 0, NComp);
+        MultiFab diff(grids, dmap, NComp, 0);
+        MultiFab::Copy(diff, S_new, 0, 0, NComp, 0);
+        MultiFab::Subtract(diff, fpi.get_mf(), 0, 0, NComp, 0);
+        max_error = std::max(max_error, diff.norm0(0));
+        max_error = std::max(max_error, diff.norm0(1));
+
+        const BoxArray& oldba = old.boxArray();
+        for (int i = 0, N = grids.size(); i < N; ++i) {
+            std::vector< std::pair<int,Box> > isects = oldba.intersections(grids[i], true, 0);
+            if (!isects.empty() && oldba[isects[0].first] == grids[i]) {
+                ++nkept;
+            } else {
+                ++nnew;
+            }
+        }
+        ++nfilled;
+
+        const Real eff_ref = efficiency(grids, parent->MakeDistributionMap(level, grids));
+        min_eff_ratio = std::min(min_eff_ratio, efficiency(grids, dmap) / eff_ref);
+    }
+
+    virtual void init () override
+    {
+        const Real cur_time  = parent->getLevel(level-1).get_state_data(State_Type).curTime();
+        const Real prev_time = parent->getLevel(level-1).get_state_data(State_Type).prevTime();
+        const Real dt_old    = (cur_time - prev_time)/static_cast<Real>(parent->MaxRefRatio(level-1));
+        setTimeLevel(cur_time, dt_old, parent->dtLevel(level));
+        FillCoarsePatch(get_new_data(State_Type), 0, cur_time, State_Type, 0, NComp);
+    }
+
+    //! Tag a ball that moves across the domain.
+    virtual void errorEst (TagBoxArray& tags,
+                           int          clearval,
+                           int          tagval,
+                           Real         time,
+                           int          n_error_buf,
+                           int          ngrow) override
+    {
+        const Real* dx = geom.CellSize();
+        const Real* lo = geom.ProbLo();
+        const Real xc = 0.25 + 0.5*time;
+        const Real r  = 0.2/(level+1);
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            TagBox& tag = tags[mfi];
+            const Box& bx = mfi.validbox();
+            for (BoxIterator bit(bx); bit.ok(); ++bit)
+            {
+                const IntVect& iv = bit();
+                const Real x = lo[0] + (iv[0]+0.5)*dx[0] - xc;
+                const Real y = lo[1] + (iv[1]+0.5)*dx[1] - 0.5;
+                const Real z = lo[2] + (iv[2]+0.5)*dx[2] - 0.5;
+                if (x*x + y*y + z*z < r*r) tag(iv) = tagval;
+            }
+        }
+    }
+};
+
+class RegridTestBld
+    :
+    public LevelBld
+{
+    virtual void variableSetUp () override { RegridTestLevel::variableSetUp(); }
+    virtual void variableCleanUp () override { RegridTestLevel::variableCleanUp(); }
+    virtual AmrLevel* operator() () override { return new RegridTestLevel; }
+    virtual AmrLevel* operator() (Amr&                       papa,
+                                  int                        lev,
+                                  const Geometry&            level_geom,
+                                  const BoxArray&            ba,
+                                  const DistributionMapping& dm,
+                                  Real                       time) override
+    {
+        return new RegridTestLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+RegridTestBld regrid_test_bld;
+
+extern "C"
+void amrex_probinit (const int* init, const int* name, const int* namelen,
+                     const amrex_real* problo, const amrex_real* probhi) {}
+
+LevelBld*
+getLevelBld ()
+{
+    return &regrid_test_bld;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int max_step = 10;
+        {
+            ParmParse pp;
+            pp.query("max_step", max_step);
+        }
+
+        Amr amr;
+        amr.init(0.0, -1.0);
+        while (amr.levelSteps(0) < max_step) {
+            amr.coarseTimeStep(-1.0);
+        }
+
+        ParallelDescriptor::ReduceRealMax(max_error);
+        amrex::Print() << nfilled << " levels refilled, " << nkept << " grids kept, " << nnew << " new, "
+                       << "max difference to FillPatchIterator " << max_error << "\n"
+                       << "lowest efficiency relative to a new distribution " << min_eff_ratio << "\n";
+
+        if (nkept == 0 || nnew == 0) {
+            amrex::Abort("The regrids did not both keep and change grids");
+        }
+        if (max_error != 0.0) {
+            amrex::Abort("The incremental FillPatch differs from FillPatchIterator");
+        }
+        if (min_eff_ratio < 0.9) {
+            amrex::Abort("An incremental regrid is poorly load balanced");
+        }
+    }
+    amrex::Finalize();
+}
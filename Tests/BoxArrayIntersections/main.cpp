@@ -0,0 +1,106 @@
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+//
+// Compare the hash and the bounding volume hierarchy (boxarray.index) in
+// BoxArray::intersections on a BoxArray of boxes of widely varying sizes,
+// as made by regridding an irregular hierarchy, with the queries of a
+// FillBoundary.
+//
+
+BoxArray make_boxarray (int n_cell, int max_grid_size);
+double query (const BoxArray& ba, int ngrow, Vector<Vector<int> >& result);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 512;
+        int max_grid_size = 64;
+        int ngrow = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ngrow", ngrow);
+        }
+
+        const BoxArray ba = make_boxarray(n_cell, max_grid_size);
+
+        long nmin = ba.numPts(), nmax = 0;
+        for (int i = 0; i < ba.size(); ++i) {
+            nmin = std::min(nmin, ba[i].numPts());
+            nmax = std::max(nmax, ba[i].numPts());
+        }
+        amrex::Print() << ba.size() << " boxes of " << nmin << " to " << nmax << " cells\n";
+
+        Vector<Vector<int> > rhash, rbvh;
+
+        BARef::use_bvh = false;
+        const double thash = query(BoxArray(ba.boxList()), ngrow, rhash);
+
+        BARef::use_bvh = true;
+        const double tbvh = query(BoxArray(ba.boxList()), ngrow, rbvh);
+
+        amrex::Print() << "hash: " << thash << " s, bvh: " << tbvh << " s"
+                       << " (including building the index)\n";
+
+        if (rhash != rbvh) {
+            amrex::Abort("The hash and the BVH found different intersections");
+        }
+        amrex::Print() << "The intersections agree\n";
+    }
+    amrex::Finalize();
+}
+
+BoxArray
+make_boxarray (int n_cell, int max_grid_size)
+{
+    // ---- chop each box of the domain into pieces of a random size
+    BoxArray crse(Box(IntVect(0), IntVect(n_cell-1)));
+    crse.maxSize(max_grid_size);
+
+    BoxList bl;
+    for (int i = 0; i < crse.size(); ++i) {
+        int sz = max_grid_size;
+        while (sz > 8 && amrex::Random() < 0.5) {
+            sz /= 2;
+        }
+        BoxList pieces(crse[i]);
+        pieces.maxSize(sz);
+        bl.join(pieces);
+    }
+
+    return BoxArray(std::move(bl));
+}
+
+double
+query (const BoxArray& ba, int ngrow, Vector<Vector<int> >& result)
+{
+    const double t0 = amrex::second();
+
+    std::vector<std::pair<int,Box> > isects;
+    result.resize(ba.size());
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        ba.intersections(amrex::grow(ba[i],ngrow), isects);
+        for (const auto& is : isects) {
+            result[i].push_back(is.first);
+        }
+    }
+
+    const double t1 = amrex::second();
+
+    for (auto& r : result) {
+        std::sort(r.begin(), r.end());
+    }
+
+    return t1 - t0;
+}
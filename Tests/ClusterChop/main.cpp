@@ -0,0 +1,130 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_Cluster.H>
+#include <AMReX_BoxIterator.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+//
+// Time ClusterList::chop and new_chop, the Berger-Rigoutsos clustering of
+// grid generation, with one thread and with all threads on the tags of a
+// few spherical shells, and check that they make the same BoxArray.  The
+// times are the best of nrep runs.
+//
+
+Vector<IntVect> make_tags (int n_cell, int nshells);
+double cluster (const Vector<IntVect>& tags, Real grid_eff, bool use_new_chop, int nrep, BoxArray& ba);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 256;
+        int nshells = 4;
+        Real grid_eff = 0.7;
+        int nrep = 5;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("nshells", nshells);
+            pp.query("grid_eff", grid_eff);
+            pp.query("nrep", nrep);
+        }
+
+        const Vector<IntVect> tags = make_tags(n_cell, nshells);
+        amrex::Print() << tags.size() << " tags\n";
+
+        int nthreads = 1;
+#ifdef _OPENMP
+        nthreads = omp_get_max_threads();
+#endif
+
+        for (int use_new_chop = 0; use_new_chop <= 1; ++use_new_chop)
+        {
+            BoxArray ba1, ban;
+#ifdef _OPENMP
+            omp_set_num_threads(1);
+#endif
+            const double t1 = cluster(tags, grid_eff, use_new_chop, nrep, ba1);
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            const double tn = cluster(tags, grid_eff, use_new_chop, nrep, ban);
+
+            amrex::Print() << (use_new_chop ? "new_chop: " : "chop:     ")
+                           << ba1.size() << " boxes, 1 thread: " << t1 << " s, "
+                           << nthreads << " threads: " << tn << " s\n";
+
+            if (ba1 != ban) {
+                amrex::Abort("The BoxArrays made with one and with all threads differ");
+            }
+        }
+        amrex::Print() << "The BoxArrays agree\n";
+    }
+    amrex::Finalize();
+}
+
+Vector<IntVect>
+make_tags (int n_cell, int nshells)
+{
+    // ---- shells of a random center and radius, one cell thick or so
+    Vector<Real> cx(nshells), cy(nshells), cz(nshells), rad(nshells);
+    for (int s = 0; s < nshells; ++s) {
+        cx[s]  = n_cell * (0.3 + 0.4*amrex::Random());
+        cy[s]  = n_cell * (0.3 + 0.4*amrex::Random());
+        cz[s]  = n_cell * (0.3 + 0.4*amrex::Random());
+        rad[s] = n_cell * (0.1 + 0.2*amrex::Random());
+    }
+
+    Vector<IntVect> tags;
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    for (BoxIterator bi(domain); bi.ok(); ++bi)
+    {
+        const IntVect& iv = bi();
+        for (int s = 0; s < nshells; ++s) {
+            const Real r2 = AMREX_D_TERM(  std::pow(iv[0]+0.5-cx[s], 2),
+                                         + std::pow(iv[1]+0.5-cy[s], 2),
+                                         + std::pow(iv[2]+0.5-cz[s], 2));
+            if (std::abs(std::sqrt(r2) - rad[s]) < 1.0) {
+                tags.push_back(iv);
+                break;
+            }
+        }
+    }
+    return tags;
+}
+
+double
+cluster (const Vector<IntVect>& tags, Real grid_eff, bool use_new_chop, int nrep, BoxArray& ba)
+{
+    double tmin = std::numeric_limits<double>::max();
+
+    for (int irep = 0; irep < nrep; ++irep)
+    {
+        // ---- ClusterList reorders the tags, so each run gets its own copy
+        Vector<IntVect> tmp = tags;
+
+        const double t0 = amrex::second();
+
+        ClusterList clist(tmp.dataPtr(), tmp.size());
+        if (use_new_chop) {
+            clist.new_chop(grid_eff);
+        } else {
+            clist.chop(grid_eff);
+        }
+        clist.boxArray(ba);
+
+        tmin = std::min(tmin, amrex::second() - t0);
+    }
+
+    return tmin;
+}
@@ -0,0 +1,316 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLCGSolver.H>
+#include <AMReX_MLDirectSolver.H>
+#include <AMReX_MLAMGSolver.H>
+#include <AMReX_MLSparseMatrix.H>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+//
+// Solve a variable coefficient MLABecLaplacian problem with each Krylov
+// solver of MLCGSolver on the whole level, and with MLMG using each
+// bottom solver, and check that all converge to the same solution.  On
+// the coarsened level, also compare the assembled matrix with the
+// operator and the direct and AMG solvers with CG.  Run it on several processes.
+//
+
+void init_coeffs (const Geometry& geom, MultiFab& acoef, Array<MultiFab,AMREX_SPACEDIM>& bcoef);
+void init_rhs (const Geometry& geom, MultiFab& rhs);
+
+namespace {
+    int nfailed = 0;
+
+    //! max |x - ref| / max |ref|
+    Real reldiff (const MultiFab& x, const MultiFab& ref)
+    {
+        MultiFab d(x.boxArray(), x.DistributionMap(), 1, 0);
+        MultiFab::Copy(d, x, 0, 0, 1, 0);
+        MultiFab::Subtract(d, ref, 0, 0, 1, 0);
+        return d.norm0() / ref.norm0();
+    }
+
+    void check (bool ok, const std::string& msg)
+    {
+        if (!ok) {
+            ++nfailed;
+            amrex::Print() << "  FAILED: " << msg << "\n";
+        }
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real krylov_tol = 1.e-10;
+        Real mlmg_tol = 1.e-10;
+        Real diff_tol = 1.e-7;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("krylov_tol", krylov_tol);
+            pp.query("mlmg_tol", mlmg_tol);
+            pp.query("diff_tol", diff_tol);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        const Geometry geom(domain, rb, 0, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+
+        MultiFab acoef(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        init_coeffs(geom, acoef, bcoef);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        init_rhs(geom, rhs);
+
+        auto setup = [&] (MLABecLaplacian& lp)
+        {
+            const LinOpBCType bct = LinOpBCType::Dirichlet;
+            lp.setDomainBC({AMREX_D_DECL(bct,bct,bct)}, {AMREX_D_DECL(bct,bct,bct)});
+            lp.setLevelBC(0, nullptr);
+            lp.setScalars(1.0, 1.0);
+            lp.setACoeffs(0, acoef);
+            lp.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+        };
+
+        MultiFab sol(ba, dm, 1, 1);
+        MultiFab res(ba, dm, 1, 0);
+
+        //
+        // The Krylov solvers on the whole level, with no coarsening.
+        //
+        {
+            amrex::Print() << "MLCGSolver on " << ba.numPts() << " cells, "
+                           << ParallelDescriptor::NProcs() << " processes\n";
+
+            MLABecLaplacian lp({geom}, {ba}, {dm}, LPInfo().setMaxCoarseningLevel(0));
+            setup(lp);
+            MLMG mlmg(lp);
+            sol.setVal(0.0);
+            mlmg.prepareForSolve({&sol}, {&rhs});
+
+            const Vector<std::pair<std::string,MLCGSolver::Type> > krylov
+                {{"CG",            MLCGSolver::Type::CG},
+                 {"BiCGStab",      MLCGSolver::Type::BiCGStab},
+                 {"PipeCG",        MLCGSolver::Type::PipeCG},
+                 {"SStepBiCGStab", MLCGSolver::Type::SStepBiCGStab}};
+
+            MultiFab ref(ba, dm, 1, 0);
+            for (int i = 0; i < krylov.size(); ++i)
+            {
+                sol.setVal(0.0);
+                MLCGSolver cg(&mlmg, lp, krylov[i].second);
+                cg.setMaxIter(1000);
+                const int ret = cg.solve(sol, rhs, krylov_tol, -1.0);
+
+                lp.apply(0, 0, res, sol, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+                MultiFab::Subtract(res, rhs, 0, 0, 1, 0);
+                const Real relres = res.norm0() / rhs.norm0();
+
+                if (i == 0) MultiFab::Copy(ref, sol, 0, 0, 1, 0);
+                const Real diff = reldiff(sol, ref);
+
+                amrex::Print() << "  " << krylov[i].first << ": return " << ret
+                               << ", residual " << relres << ", difference to CG " << diff << "\n";
+                check(ret == 0, krylov[i].first + " did not converge");
+                check(relres <= 10.0*krylov_tol, krylov[i].first + " residual too large");
+                check(diff <= diff_tol, krylov[i].first + " differs from CG");
+            }
+        }
+
+        //
+        // MLMG with each bottom solver.  MLMG aborts if a solve fails.  With
+        // one coarsening the bottom level is large enough for the bottom
+        // solver to matter.
+        //
+        {
+            amrex::Print() << "MLMG bottom solvers\n";
+
+            const Vector<std::pair<std::string,BottomSolver> > bottom
+                {{"default",       BottomSolver::Default},
+                 {"bicgstab",      BottomSolver::bicgstab},
+                 {"cg",            BottomSolver::cg},
+                 {"pipecg",        BottomSolver::pipecg},
+                 {"sstepbicgstab", BottomSolver::sstepbicgstab},
+                 {"direct",        BottomSolver::direct},
+                 {"amg",           BottomSolver::amg}};
+
+            MultiFab ref(ba, dm, 1, 0);
+            for (int i = 0; i < bottom.size(); ++i)
+            {
+                MLABecLaplacian lp({geom}, {ba}, {dm}, LPInfo().setMaxCoarseningLevel(1));
+                setup(lp);
+                MLMG mlmg(lp);
+                mlmg.setVerbose(0);
+                mlmg.setBottomSolver(bottom[i].second);
+                sol.setVal(0.0);
+                mlmg.solve({&sol}, {&rhs}, mlmg_tol, 0.0);
+
+                if (i == 0) MultiFab::Copy(ref, sol, 0, 0, 1, 0);
+                const Real diff = reldiff(sol, ref);
+
+                amrex::Print() << "  " << bottom[i].first << ": difference to the default " << diff << "\n";
+                check(diff <= diff_tol, bottom[i].first + " differs from the default");
+            }
+        }
+
+        //
+        // The assembled matrix and the direct solver on the coarsened level.
+        //
+        {
+            amrex::Print() << "Coarsened level\n";
+
+            MLABecLaplacian lp({geom}, {ba}, {dm}, LPInfo().setMaxCoarseningLevel(1)
+                                                           .setAgglomeration(false)
+                                                           .setConsolidation(false));
+            setup(lp);
+            MLMG mlmg(lp);
+            sol.setVal(0.0);
+            mlmg.prepareForSolve({&sol}, {&rhs});
+
+            const Geometry cgeom(amrex::coarsen(domain,2), rb, 0, is_periodic);
+            const BoxArray cba = amrex::coarsen(ba,2);
+            MultiFab cb(cba, dm, 1, 0);
+            MultiFab cres(cba, dm, 1, 0);
+            init_rhs(cgeom, cb);
+
+            MLSparseMatrix mat;
+            check(lp.assembleMatrix(0, 1, mat), "assembleMatrix failed");
+            MultiFab cx(cba, dm, 1, std::max(mat.radius(),1));
+            cx.setVal(0.0);
+            MultiFab::Copy(cx, cb, 0, 0, 1, 0);
+            mat.apply(cres, cx);
+            MultiFab lx(cba, dm, 1, 0);
+            lp.apply(0, 1, lx, cx, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            const Real matdiff = reldiff(cres, lx);
+            amrex::Print() << "  assembled matrix: difference to the operator " << matdiff << "\n";
+            check(matdiff <= 1.e-12, "the assembled matrix differs from the operator");
+
+            MLDirectSolver direct(lp, 0, 1);
+            const bool defined = direct.define(cx, cba.numPts());
+            check(defined, "MLDirectSolver::define failed");
+            if (defined)
+            {
+                cx.setVal(0.0);
+                direct.solve(cx, cb);
+                lp.apply(0, 1, cres, cx, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+                MultiFab::Subtract(cres, cb, 0, 0, 1, 0);
+                const Real relres = cres.norm0() / cb.norm0();
+
+                MultiFab cg_x(cba, dm, 1, 1);
+                cg_x.setVal(0.0);
+                MLCGSolver cg(&mlmg, lp, MLCGSolver::Type::CG);
+                cg.setMaxIter(1000);
+                cg.solve(cg_x, cb, 1.e-12, -1.0);
+                const Real diff = reldiff(cx, cg_x);
+
+                amrex::Print() << "  direct: residual " << relres << ", difference to CG " << diff << "\n";
+                check(relres <= 1.e-10, "direct solver residual too large");
+                check(diff <= diff_tol, "direct solver differs from CG");
+
+                MLAMGSolver amg(lp, 0, 1);
+                amg.setTolerance(1.e-11);
+                amg.setMaxIter(100);
+                const bool amg_defined = amg.define(cx, cba.numPts());
+                check(amg_defined, "MLAMGSolver::define failed");
+                if (amg_defined)
+                {
+                    cx.setVal(0.0);
+                    amg.solve(cx, cb);
+                    lp.apply(0, 1, cres, cx, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+                    MultiFab::Subtract(cres, cb, 0, 0, 1, 0);
+                    const Real amgres = cres.norm0() / cb.norm0();
+                    const Real amgdiff = reldiff(cx, cg_x);
+
+                    amrex::Print() << "  amg: residual " << amgres << ", difference to CG " << amgdiff << "\n";
+                    check(amgres <= 1.e-9, "AMG solver residual too large");
+                    check(amgdiff <= diff_tol, "AMG solver differs from CG");
+                }
+            }
+        }
+
+        if (nfailed > 0) {
+            amrex::Abort("The solvers do not agree");
+        }
+    }
+    amrex::Finalize();
+}
+
+void
+init_coeffs (const Geometry& geom, MultiFab& acoef, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    const Real* dx = geom.CellSize();
+
+    for (MFIter mfi(acoef); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& a = acoef.array(mfi);
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            a(i,j,k) = 1.0 + 0.5*std::sin(2.0*M_PI*(i+0.5)*dx[0]);
+        }}}
+    }
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& b = bcoef[idim].array(mfi);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                b(i,j,k) = 1.0 + 0.25*std::cos(2.0*M_PI*j*dx[1]);
+            }}}
+        }
+    }
+}
+
+void
+init_rhs (const Geometry& geom, MultiFab& rhs)
+{
+    const Real* dx = geom.CellSize();
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& a = rhs.array(mfi);
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            a(i,j,k) = std::sin(2.0*M_PI*x) * std::cos(3.0*M_PI*y) * std::sin(M_PI*z) + 0.5;
+        }}}
+    }
+}
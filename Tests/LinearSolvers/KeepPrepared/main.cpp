@@ -0,0 +1,171 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+//
+// Keep one MLABecLaplacian prepared with MLLinOp::setKeepPrepared through
+// several solves that change its scalars and coefficients, then redefine
+// it on a different BoxArray, and check every solve against an operator
+// built afresh for it.  Run it on several processes.
+//
+
+namespace {
+
+    void fill (MultiFab& mf, Real c, Real s)
+    {
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& a = mf.array(mfi);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                a(i,j,k) = c + s*std::sin(0.1*i + 0.2*j + 0.3*k);
+            }}}
+        }
+    }
+
+    //! The data of one problem on a BoxArray
+    struct Problem
+    {
+        BoxArray ba;
+        DistributionMapping dm;
+        MultiFab phi;
+        MultiFab rhs;
+        MultiFab acoef;
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+
+        Problem (const Box& domain, int max_grid_size)
+            : ba(domain)
+        {
+            ba.maxSize(max_grid_size);
+            dm.define(ba);
+            phi.define(ba, dm, 1, 1);
+            rhs.define(ba, dm, 1, 0);
+            acoef.define(ba, dm, 1, 0);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+            }
+            fill(rhs, 0.0, 1.0);
+        }
+
+        //! The coefficients of a step.  The b coefficients change every other step.
+        void setStep (int step)
+        {
+            fill(acoef, 1.0, 0.1*step);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                fill(bcoef[idim], 2.0, 0.5 + 0.2*(step/2));
+            }
+        }
+    };
+
+    //! Set the coefficients of step on lp, the b coefficients only if set_b, and solve.
+    void solve (MLABecLaplacian& lp, Problem& p, int step, bool set_b, Real tol)
+    {
+        const LinOpBCType bct = LinOpBCType::Dirichlet;
+        lp.setDomainBC({AMREX_D_DECL(bct,bct,bct)}, {AMREX_D_DECL(bct,bct,bct)});
+        p.setStep(step);
+        lp.setScalars(1.0 + step, 1.0);
+        lp.setACoeffs(0, p.acoef);
+        if (set_b) {
+            lp.setBCoeffs(0, amrex::GetArrOfConstPtrs(p.bcoef));
+        }
+        p.phi.setVal(0.0);
+        lp.setLevelBC(0, &p.phi);
+        MLMG mlmg(lp);
+        mlmg.setVerbose(0);
+        mlmg.solve({&p.phi}, {&p.rhs}, tol, 0.0);
+    }
+
+    //! max |x - ref| / max |ref|
+    Real reldiff (const MultiFab& x, const MultiFab& ref)
+    {
+        MultiFab d(x.boxArray(), x.DistributionMap(), 1, 0);
+        MultiFab::Copy(d, x, 0, 0, 1, 0);
+        MultiFab::Subtract(d, ref, 0, 0, 1, 0);
+        return d.norm0() / ref.norm0();
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int redefined_max_grid_size = 16;
+        int nsteps = 4;
+        Real tol = 1.e-10;
+        Real diff_tol = 1.e-9;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("redefined_max_grid_size", redefined_max_grid_size);
+            pp.query("nsteps", nsteps);
+            pp.query("tol", tol);
+            pp.query("diff_tol", diff_tol);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        const Geometry geom(domain, rb, 0, is_periodic);
+
+        int nfailed = 0;
+
+        Problem kept(domain, max_grid_size);
+        Problem fresh(domain, max_grid_size);
+
+        MLABecLaplacian lp({geom}, {kept.ba}, {kept.dm});
+        lp.setKeepPrepared(true);
+
+        //
+        // Change the scalars and coefficients of the kept operator.
+        //
+        for (int step = 0; step < nsteps; ++step)
+        {
+            solve(lp, kept, step, step % 2 == 0, tol);
+
+            MLABecLaplacian lp_fresh({geom}, {fresh.ba}, {fresh.dm});
+            solve(lp_fresh, fresh, step, true, tol);
+
+            const Real diff = reldiff(kept.phi, fresh.phi);
+            amrex::Print() << "step " << step << ": difference to a new operator " << diff << "\n";
+            if (!(diff <= diff_tol)) ++nfailed;
+        }
+
+        //
+        // Redefine the kept operator on a different BoxArray.
+        //
+        {
+            Problem redefined(domain, redefined_max_grid_size);
+            Problem fresh2(domain, redefined_max_grid_size);
+
+            lp.define({geom}, {redefined.ba}, {redefined.dm});
+            solve(lp, redefined, nsteps, true, tol);
+
+            MLABecLaplacian lp_fresh({geom}, {fresh2.ba}, {fresh2.dm});
+            solve(lp_fresh, fresh2, nsteps, true, tol);
+
+            const Real diff = reldiff(redefined.phi, fresh2.phi);
+            amrex::Print() << "redefined on " << redefined.ba.size() << " boxes: difference to a new operator "
+                           << diff << "\n";
+            if (!(diff <= diff_tol)) ++nfailed;
+        }
+
+        if (nfailed > 0) {
+            amrex::Abort("A kept operator differs from a new one");
+        }
+    }
+    amrex::Finalize();
+}
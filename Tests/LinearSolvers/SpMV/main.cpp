@@ -0,0 +1,178 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLSparseMatrix.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+//
+// Assemble the matrix of an MLABecLaplacian with MLLinOp::assembleMatrix and
+// compare the assembled product, MLSparseMatrix::apply, with the
+// matrix-free MLLinOp::apply, in time and in the memory traffic each of
+// them needs per cell.
+//
+
+void init_coeffs (const Geometry& geom, MultiFab& acoef, Array<MultiFab,AMREX_SPACEDIM>& bcoef);
+void init_x (const Geometry& geom, MultiFab& x);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 128;
+        int max_grid_size = 32;
+        int nrep = 20;
+        int periodic = 0;
+        Real tol = 1.e-12;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nrep", nrep);
+            pp.query("periodic", periodic);
+            pp.query("tol", tol);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(periodic,periodic,periodic)};
+        const Geometry geom(domain, rb, 0, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+
+        MultiFab acoef(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        init_coeffs(geom, acoef, bcoef);
+
+        MLABecLaplacian mlabec({geom}, {ba}, {dm});
+        const LinOpBCType bct = periodic ? LinOpBCType::Periodic : LinOpBCType::Dirichlet;
+        mlabec.setDomainBC({AMREX_D_DECL(bct,bct,bct)}, {AMREX_D_DECL(bct,bct,bct)});
+        mlabec.setLevelBC(0, nullptr);
+        mlabec.setScalars(1.0, 1.0);
+        mlabec.setACoeffs(0, acoef);
+        mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+        mlabec.prepareForSolve();
+
+        double t0 = amrex::second();
+        MLSparseMatrix mat;
+        if (!mlabec.assembleMatrix(0, 0, mat)) {
+            amrex::Abort("Failed to assemble the matrix");
+        }
+        const double tassemble = amrex::second() - t0;
+
+        long nnz = mat.numLocalNonZeros();
+        ParallelDescriptor::ReduceLongSum(nnz);
+        const long ncells = ba.numPts();
+        amrex::Print() << ncells << " cells, " << nnz << " nonzeros ("
+                       << static_cast<double>(nnz)/ncells << " per row), assembled in "
+                       << tassemble << " s\n";
+
+        MultiFab x(ba, dm, 1, mat.radius());
+        MultiFab y_free(ba, dm, 1, 0);
+        MultiFab y_mat(ba, dm, 1, 0);
+        init_x(geom, x);
+
+        // Warm up and check that both give the same result
+        mlabec.apply(0, 0, y_free, x, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        mat.apply(y_mat, x);
+        MultiFab::Subtract(y_mat, y_free, 0, 0, 1, 0);
+        const Real reldiff = y_mat.norm0() / y_free.norm0();
+        amrex::Print() << "max |A x - L x| / max |L x| = " << reldiff << "\n";
+        if (!(reldiff <= tol)) {
+            amrex::Abort("The assembled and matrix-free products differ by more than tol");
+        }
+
+        ParallelDescriptor::Barrier();
+        t0 = amrex::second();
+        for (int i = 0; i < nrep; ++i) {
+            mlabec.apply(0, 0, y_free, x, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        }
+        ParallelDescriptor::Barrier();
+        const double tfree = (amrex::second() - t0) / nrep;
+
+        t0 = amrex::second();
+        for (int i = 0; i < nrep; ++i) {
+            mat.apply(y_mat, x);
+        }
+        ParallelDescriptor::Barrier();
+        const double tmat = (amrex::second() - t0) / nrep;
+
+        // Minimum memory traffic per cell: the matrix-free operator reads x,
+        // a and one b per face and writes y; the assembled one reads x, the
+        // row start and each entry's value and stencil offset and writes y.
+        const double bfree = (3 + AMREX_SPACEDIM) * sizeof(Real);
+        const double bmat = 2*sizeof(Real) + sizeof(int)
+            + static_cast<double>(nnz)/ncells * (sizeof(Real) + sizeof(int));
+
+        amrex::Print() << "matrix-free apply: " << tfree << " s, "
+                       << bfree << " bytes/cell, " << bfree*ncells/tfree*1.e-9 << " GB/s\n"
+                       << "assembled apply:   " << tmat << " s, "
+                       << bmat << " bytes/cell, " << bmat*ncells/tmat*1.e-9 << " GB/s\n";
+    }
+    amrex::Finalize();
+}
+
+void
+init_coeffs (const Geometry& geom, MultiFab& acoef, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    const Real* dx = geom.CellSize();
+
+    for (MFIter mfi(acoef); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& a = acoef.array(mfi);
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            a(i,j,k) = 1.0 + 0.5*std::sin(2.0*M_PI*(i+0.5)*dx[0]);
+        }}}
+    }
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+            const auto& b = bcoef[idim].array(mfi);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                b(i,j,k) = 1.0 + 0.25*std::cos(2.0*M_PI*j*dx[1]);
+            }}}
+        }
+    }
+}
+
+void
+init_x (const Geometry& geom, MultiFab& x)
+{
+    const Real* dx = geom.CellSize();
+
+    x.setVal(0.0);
+    for (MFIter mfi(x); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        const auto& a = x.array(mfi);
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            a(i,j,k) = std::sin(2.0*M_PI*(i+0.5)*dx[0]) * std::cos(2.0*M_PI*(j+0.5)*dx[1]);
+        }}}
+    }
+}
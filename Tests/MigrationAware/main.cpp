@@ -0,0 +1,83 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+//
+// Distribute a level whose old data are all on process 0 with the
+// migration-aware knapsack, and check that no process gets more than nmax
+// boxes, for migration weights that prefer balance and that prefer
+// keeping the data.
+//
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int old_grid_size = 32;
+        int new_grid_size = 8;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("old_grid_size", old_grid_size);
+            pp.query("new_grid_size", new_grid_size);
+        }
+
+        const int nprocs = ParallelDescriptor::NProcs();
+        if (nprocs < 2) {
+            amrex::Abort("Run this test on more than one process");
+        }
+
+        const Box domain(IntVect(AMREX_D_DECL(0,0,0)),
+                         IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+
+        BoxArray oldba(domain);
+        oldba.maxSize(old_grid_size);
+        const DistributionMapping olddm(Vector<int>(oldba.size(), 0));
+
+        BoxArray ba(domain);
+        ba.maxSize(new_grid_size);
+        const int N = ba.size();
+
+        // The boxes in the lower half of the domain are ten times as costly.
+        MultiFab weight(ba, DistributionMapping(ba), 1, 0);
+        for (MFIter mfi(weight); mfi.isValid(); ++mfi) {
+            const Box& bx = mfi.validbox();
+            weight[mfi].setVal((bx.smallEnd(0) < n_cell/2) ? 10.0 : 1.0);
+        }
+
+        const Real navg = static_cast<Real>(N) / static_cast<Real>(nprocs);
+        const int  nmax = static_cast<int>(std::ceil(1.5*navg));
+
+        for (Real w : {0.0, 1.e10})
+        {
+            const DistributionMapping uncapped
+                = DistributionMapping::makeKnapSack(weight, oldba, olddm, w);
+            const DistributionMapping capped
+                = DistributionMapping::makeKnapSack(weight, oldba, olddm, w, nmax);
+
+            Vector<int> nuncapped(nprocs, 0);
+            Vector<int> ncapped(nprocs, 0);
+            for (int i = 0; i < N; ++i) {
+                ++nuncapped[uncapped[i]];
+                ++ncapped[capped[i]];
+            }
+            const int umax = *std::max_element(nuncapped.begin(), nuncapped.end());
+            const int cmax = *std::max_element(ncapped.begin(), ncapped.end());
+
+            amrex::Print() << "migration weight " << w << ": at most " << umax
+                           << " boxes per process, " << cmax << " with nmax = " << nmax << "\n";
+
+            if (cmax > nmax) {
+                amrex::Abort("The migration-aware knapsack exceeds nmax");
+            }
+        }
+    }
+    amrex::Finalize();
+}
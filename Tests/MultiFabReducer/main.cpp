@@ -0,0 +1,147 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_MultiFabReducer.H>
+#include <AMReX_ParmParse.H>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+using namespace amrex;
+
+//
+// Compare MultiFabReducer::eval and evalAsync with MultiFab::sum, norm0,
+// norm1, norm2, min, max and Dot, with and without a mask.  Run it on
+// several processes.
+//
+
+namespace {
+
+    void fill (MultiFab& x, MultiFab& y, iMultiFab& mask)
+    {
+        for (MFIter mfi(x); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            const auto& xa = x.array(mfi);
+            const auto& ya = y.array(mfi);
+            const auto& ma = mask.array(mfi);
+            const auto lo = lbound(bx);
+            const auto hi = ubound(bx);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                xa(i,j,k) = std::sin(0.3*i + 0.7*j) * std::cos(0.5*k) - 0.1;
+                ya(i,j,k) = std::cos(0.2*i - 0.4*k) + 0.01*j;
+                // Leave out the extrema, so that the masked min and max differ
+                ma(i,j,k) = ((i+2*j+k) % 3 != 0 && std::abs(xa(i,j,k)) < 0.8) ? 1 : 0;
+            }}}
+        }
+    }
+
+    //! A copy of x with the masked-out cells set to val.
+    MultiFab masked (const MultiFab& x, const iMultiFab& mask, Real val)
+    {
+        MultiFab r(x.boxArray(), x.DistributionMap(), 1, x.nGrow());
+        MultiFab::Copy(r, x, 0, 0, 1, x.nGrow());
+        for (MFIter mfi(r); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            const auto& ra = r.array(mfi);
+            const auto& ma = mask.array(mfi);
+            const auto lo = lbound(bx);
+            const auto hi = ubound(bx);
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                if (ma(i,j,k) == 0) ra(i,j,k) = val;
+            }}}
+        }
+        return r;
+    }
+
+    int nfailed = 0;
+
+    void check (const std::string& name, Real v, Real ref, Real tol)
+    {
+        const Real err = std::abs(v - ref);
+        const bool ok = err <= tol * std::max(std::abs(ref), Real(1.0));
+        if (!ok) ++nfailed;
+        amrex::Print() << "  " << name << ": " << v << " vs " << ref
+                       << (ok ? "" : "  FAILED") << "\n";
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const Box domain(IntVect(AMREX_D_DECL(0,0,0)),
+                         IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ng = 1;
+        MultiFab x(ba, dm, 1, ng);
+        MultiFab y(ba, dm, 1, ng);
+        iMultiFab mask(ba, dm, 1, ng);
+        fill(x, y, mask);
+
+        const Real big = std::numeric_limits<Real>::max();
+        const MultiFab xzero = masked(x, mask, 0.0);
+        const MultiFab xbig  = masked(x, mask, big);
+        const MultiFab xlow  = masked(x, mask, -big);
+
+        Vector<std::string> names;
+        Vector<Real> refs;
+        MultiFabReducer r;
+
+        r.addSum  (x, 0);          names.push_back("sum");   refs.push_back(x.sum(0));
+        r.addMin  (x, 0, ng);      names.push_back("min");   refs.push_back(x.min(0, ng));
+        r.addMax  (x, 0, ng);      names.push_back("max");   refs.push_back(x.max(0, ng));
+        r.addNorm0(x, 0, ng);      names.push_back("norm0"); refs.push_back(x.norm0(0, ng));
+        r.addNorm1(x, 0, ng);      names.push_back("norm1"); refs.push_back(x.norm1(0, ng));
+        r.addNorm2(x, 0);          names.push_back("norm2"); refs.push_back(x.norm2(0));
+        r.addDot  (x, 0, y, 0, ng); names.push_back("dot");  refs.push_back(MultiFab::Dot(x, 0, y, 0, 1, ng));
+
+        r.addSum  (x, 0, 0, &mask);  names.push_back("masked sum");   refs.push_back(xzero.sum(0));
+        r.addMin  (x, 0, ng, &mask); names.push_back("masked min");   refs.push_back(xbig.min(0, ng));
+        r.addMax  (x, 0, ng, &mask); names.push_back("masked max");   refs.push_back(xlow.max(0, ng));
+        r.addNorm0(x, 0, ng, &mask); names.push_back("masked norm0"); refs.push_back(x.norm0(mask, 0, ng));
+        r.addNorm1(x, 0, ng, &mask); names.push_back("masked norm1"); refs.push_back(xzero.norm1(0, ng));
+        r.addNorm2(x, 0, 0, &mask);  names.push_back("masked norm2"); refs.push_back(xzero.norm2(0));
+        r.addDot  (x, 0, y, 0, ng, &mask);
+        names.push_back("masked dot");
+        refs.push_back(MultiFab::Dot(mask, x, 0, y, 0, 1, ng));
+
+        const Real tol = 1.e-12;
+
+        amrex::Print() << "eval on " << ParallelDescriptor::NProcs() << " processes\n";
+        const Vector<Real> v = r.eval();
+        for (int i = 0; i < r.size(); ++i) {
+            check(names[i], v[i], refs[i], tol);
+        }
+
+        amrex::Print() << "evalAsync\n";
+        MultiFabReducer::Handle h = r.evalAsync();
+        const Vector<Real>& va = h.get();
+        for (int i = 0; i < r.size(); ++i) {
+            check(names[i], va[i], refs[i], tol);
+        }
+
+        if (nfailed > 0) {
+            amrex::Abort("MultiFabReducer differs from the MultiFab reductions");
+        }
+    }
+    amrex::Finalize();
+}
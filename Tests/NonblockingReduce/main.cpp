@@ -0,0 +1,115 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <utility>
+
+using namespace amrex;
+
+//
+// Start several nonblocking reductions at once, poll them with Test while
+// doing other work, and compare the results with the known values and
+// with the blocking reductions.  Run it on several processes.
+//
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int myproc = ParallelDescriptor::MyProc();
+        if (nprocs < 2) {
+            amrex::Abort("Run this test on more than one process");
+        }
+
+        const int n = 5;
+
+        Real rsum = myproc + 1;
+        Real rmax = myproc;
+        Real rmin = myproc;
+        long lsum = 2*myproc;
+        Vector<Real> vsum(n), vmax(n), vmin(n);
+        Vector<long> lvsum(n);
+        for (int i = 0; i < n; ++i) {
+            vsum[i]  = i + myproc;
+            vmax[i]  = (myproc == i % nprocs) ? 100.0+i : -Real(myproc);
+            vmin[i]  = (myproc == i % nprocs) ? -100.0-i : Real(myproc);
+            lvsum[i] = i*myproc;
+        }
+
+        Vector<Real> bsum(vsum), bmax(vmax), bmin(vmin);
+        ParallelDescriptor::ReduceRealSum(bsum.data(), n);
+        ParallelDescriptor::ReduceRealMax(bmax.data(), n);
+        ParallelDescriptor::ReduceRealMin(bmin.data(), n);
+
+        ParallelDescriptor::ReduceRequest rq0 = ParallelDescriptor::IReduceRealSum(rsum);
+        ParallelDescriptor::ReduceRequest rq1 = ParallelDescriptor::IReduceRealMax(rmax);
+        ParallelDescriptor::ReduceRequest rq2 = ParallelDescriptor::IReduceRealMin(rmin);
+        ParallelDescriptor::ReduceRequest rq3 = ParallelDescriptor::IReduceLongSum(lsum);
+        ParallelDescriptor::ReduceRequest rq4 = ParallelDescriptor::IReduceRealSum(vsum.data(), n);
+        ParallelDescriptor::ReduceRequest rq5 = ParallelDescriptor::IReduceRealMax(vmax.data(), n);
+        ParallelDescriptor::ReduceRequest rq6 = ParallelDescriptor::IReduceRealMin(vmin.data(), n);
+        ParallelDescriptor::ReduceRequest rq7 = ParallelDescriptor::IReduceLongSum(lvsum.data(), n);
+
+        // Work while the reductions proceed.
+        long npolls = 0;
+        Real work = 0.0;
+        while (!rq0.Test()) {
+            for (int i = 0; i < 1000; ++i) work += 1.e-3*i;
+            ++npolls;
+        }
+
+        rq1.Wait();
+        rq2.Wait();
+        rq3.Wait();
+
+        // A moved request is still waited for.
+        ParallelDescriptor::ReduceRequest moved(std::move(rq4));
+        moved.Wait();
+        rq4.Wait();
+        if (!rq4.Test()) {
+            amrex::Abort("An empty ReduceRequest is not complete");
+        }
+
+        // Destroying a pending request waits for it.
+        {
+            ParallelDescriptor::ReduceRequest a = std::move(rq5);
+            ParallelDescriptor::ReduceRequest b = std::move(rq6);
+            ParallelDescriptor::ReduceRequest c = std::move(rq7);
+        }
+
+        int nfailed = 0;
+        auto check = [&] (const char* name, Real v, Real ref)
+        {
+            if (v != ref) {
+                ++nfailed;
+                amrex::AllPrint() << "Rank " << myproc << ": " << name << " = " << v
+                                  << ", expected " << ref << "\n";
+            }
+        };
+
+        check("sum",  rsum, Real(nprocs*(nprocs+1)/2));
+        check("max",  rmax, Real(nprocs-1));
+        check("min",  rmin, 0.0);
+        check("long sum", Real(lsum), Real(nprocs*(nprocs-1)));
+        for (int i = 0; i < n; ++i) {
+            check("array sum", vsum[i], bsum[i]);
+            check("array max", vmax[i], bmax[i]);
+            check("array min", vmin[i], bmin[i]);
+            check("array sum", vsum[i], Real(nprocs*i + nprocs*(nprocs-1)/2));
+            check("array max", vmax[i], 100.0+i);
+            check("array min", vmin[i], -100.0-i);
+            check("long array sum", Real(lvsum[i]), Real(i*nprocs*(nprocs-1)/2));
+        }
+
+        ParallelDescriptor::ReduceIntSum(nfailed);
+        amrex::Print() << "Nonblocking reductions on " << nprocs << " processes, "
+                       << npolls << " polls on rank 0 before the first completed\n";
+        if (nfailed > 0) {
+            amrex::Abort("A nonblocking reduction differs from the expected value");
+        }
+    }
+    amrex::Finalize();
+}
@@ -141,6 +141,13 @@ function (configure_amrex)
          $<$<CXX_COMPILER_ID:Cray>:-h;noomp> )     
    endif ()
    
+ 
+   #
+   # VisMF::AsyncWrite uses a std::thread
+   #
+   find_package(Threads REQUIRED)
+   target_link_libraries(amrex PUBLIC Threads::Threads)
+
    #
    # Setup third-party profilers
    # 
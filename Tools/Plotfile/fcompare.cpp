@@ -194,7 +194,7 @@ int main_main()
         Vector<int> has_nan_b(ncomp_a, false);
         for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
             if (ivar_b[icomp_a] >= 0) {
-                const MultiFab& mf_a = pf_a.get(ilev, names_a[icomp_a]);
+                const MultiFab& mf_a = pf_a.getView(ilev, names_a[icomp_a]);
                 MultiFab mf_b;
                 if (grids_match) {
                     mf_b = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
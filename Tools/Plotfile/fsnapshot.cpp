@@ -197,7 +197,7 @@ void main_main()
     Real gmn = std::numeric_limits<Real>::max();
 
     for (int ilev = 0; ilev <= max_level; ++ilev) {
-        const MultiFab& pltmf = pf.get(ilev, compname);
+        const MultiFab& pltmf = pf.getView(ilev, compname);
         gmx = std::max(gmx, pltmf.max(0));
         gmn = std::min(gmn, pltmf.min(0));
         if (ilev < max_level) {